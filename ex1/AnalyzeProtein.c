@@ -9,31 +9,66 @@
  *
  * @section DESCRIPTION
  * The system encrypts a msg based on caesar's cipher.
- * Input  : one or moe PDB files.
+ * Input  : one or moe PDB files (of any number of atoms), optionally preceded by:
+ *          --dmax=<hull|brute|check>: the Dmax engine. hull (the default) searches only the
+ *          vertices of the atoms' convex hull, brute compares every pair of atoms (in cache
+ *          sized tiles, on the cores that are left for every file), and check runs both and
+ *          warns when they disagree.
+ *          --jobs=<n>: the number of files analyzed in parallel (default: one per core).
+ *          --stream: analyze every file in bounded memory, while it is being read (Dmax is
+ *          computed from a running summary of the atoms' convex hull, so it can't be
+ *          combined with --dmax=check).
+ *          --cache: read the atoms of every file from a binary sidecar next to it
+ *          (<fileName>.apc, holding the packed coordinates), and write the sidecar when it is
+ *          missing or out of date (can't be combined with --stream).
+ *          --contacts=<cutoff>: also count the pairs of atoms that lie within <cutoff> of each
+ *          other, through a spatial grid of the atoms (can't be combined with --stream).
+ *          --bench: instead of the analysis, times every phase of it (see runBenchmarks) on
+ *          the supplied files, and on synthetic proteins of 10k to 1M atoms that are built from
+ *          the first file. see also: make bench.
  * Process: reads the valid atom lines from the supplied PDB files, and analyze
- *          the proteins described by them, one by one. in the analyze process the
+ *          the proteins described by them, in parallel. in the analyze process the
  *          program computes the Gravity center, Ionic radius and maximal distance
  *          value of the protein and emits them in th following form:
  *          PDB file <fileName>, <numOfAtomsFound> atoms were read
  *          Cg = <Gravity center.x> <Gravity center.y> <Gravity center.z>
  *          Rg = <Ionic radius>
  *          Dmax = <maximal distance>
- * Output : prints the protein analyze as mentioned above.
+ *          and, with --contacts=<cutoff>:
+ *          Contacts = <numOfPairs> within <cutoff>
+ *          Atoms in contact = <numOfAtoms>
+ *          Neighbors per atom = <mean>, max <max>
+ *          Mean contact distance = <mean distance of the pairs>
+ * Output : prints the protein analyze as mentioned above, for every file, in the order the
+ *          files were supplied (even though they are analyzed in parallel).
  *          when success- exit with 0, else- prints an informative error massage to the
- *          stderr, and exit with EXIT_FAILURE.
+ *          stderr for every file that failed (the other files are still analyzed), and exit
+ *          with EXIT_FAILURE.
+ * Compile: gcc -Wall -Wvla -std=c99 -pthread AnalyzeProtein.c -lm (or: make)
+ *          (add -mavx2, or -march=native, for the AVX2 kernels. aarch64 builds use NEON).
  */
 //----------------------includes-------------------------------------------------------------------
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <assert.h>
 #include <stdlib.h>
 #include <memory.h>
 #include <math.h>
+#include <float.h>
 #include <errno.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 //----------------------NUMERIC CONSTANTS------------------------------------------------------------
-/**
- * represents the maximum num of atoms we are able to analyze in ope protein
- */
-#define MAX_NUM_OF_ATOMS 20000
 /**
  * represents the minimum length of a valid atom line, i.e: see ATOM_PREFIX
  */
@@ -46,6 +81,14 @@
  * represents the num of atom dimensions we will be working on
  */
 #define DIMENSIONS 3
+/**
+ * represents the size of a cache line: the alignment of the atom store's coordinate arrays
+ */
+#define CACHE_LINE_SIZE 64
+/**
+ * represents the capacity of an atom store's first allocation (when nothing is reserved)
+ */
+#define ATOM_STORE_INITIAL_CAPACITY 1024
 
 /**
  * represents the starting index of the atom line segment that holds the prefix
@@ -71,322 +114,3383 @@
  * represents the size of the atom line segment that holds the coordinate x, y or z val
  */
 #define COORDINATE_SIZE 8
+/**
+ * represents the largest mantissa (i.e: the coordinate's digits, without the decimal point) that
+ * is exact in a float (2^24). parseCoordinate falls back to strtof above it.
+ */
+#define MAX_EXACT_MANTISSA 16777216L
+/**
+ * represents the num of atoms (doubles) whose coordinates the SIMD kernels accumulate at once
+ */
+#define SIMD_ATOMS 4
+/**
+ * represents the num of bytes the streaming reader reads from a file at once
+ */
+#define STREAM_BLOCK_SIZE (1 << 20)
+/**
+ * represents the num of atoms in every chunk that the streaming reader hands to the analysis
+ */
+#define STREAM_CHUNK_ATOMS (1 << 16)
+/**
+ * represents the num of chunks that the streaming reader and the analysis take turns in
+ */
+#define STREAM_CHUNKS 2
+/**
+ * represents the minimal num of atoms that span a 3D convex hull (a tetrahedron)
+ */
+#define MIN_ATOMS_FOR_HULL 4
+/**
+ * represents the initial capacity of the hull's dynamic arrays (faces, outside sets)
+ */
+#define HULL_INITIAL_CAPACITY 16
+/**
+ * represents the largest difference between two Dmax values that prints the same (%.3f)
+ */
+#define DMAX_CHECK_TOLERANCE 0.0005
+/**
+ * represents the num of atoms in every tile of the brute force Dmax search: the coordinates of
+ * a pair of tiles (2 * 3 * 512 floats, 12KB) stay in the L1 cache while their pairs are compared
+ */
+#define DMAX_TILE_ATOMS 512
+/**
+ * represents the minimal num of tile pairs that is worth another thread of the brute force search
+ */
+#define MIN_TILE_PAIRS_PER_THREAD 4
+/**
+ * represents the num of hull vertices above which their pairs are compared by the tiled, threaded
+ * brute force search (rather than by a plain loop), as a sphere-like protein keeps most of its
+ * atoms on its hull
+ */
+#define MAX_HULL_VERTICES_FOR_LOOP DMAX_TILE_ATOMS
+/**
+ * represents the version of the sidecar cache format (see CacheHeader)
+ */
+#define CACHE_VERSION 1
+/**
+ * represents a value that reads back differently on a machine of another byte order
+ */
+#define CACHE_BYTE_ORDER 0x01020304
+/**
+ * represents the offset basis of the FNV-1a hash that hashFileContent is based on
+ */
+#define HASH_OFFSET_BASIS 14695981039346656037ULL
+/**
+ * represents the prime of the FNV-1a hash that hashFileContent is based on
+ */
+#define HASH_PRIME 1099511628211ULL
+/**
+ * represents the largest num of grid cells per atom: sparse atom sets get larger cells instead
+ */
+#define MAX_GRID_CELLS_PER_ATOM 2
+/**
+ * represents the minimal time (in seconds) every benchmark phase is repeated for
+ */
+#define BENCH_MIN_SECONDS 0.2
+/**
+ * represents the num of atoms of the smallest synthetic benchmark protein
+ */
+#define BENCH_MIN_SYNTHETIC_ATOMS 10000
+/**
+ * represents the num of atoms of the largest synthetic benchmark protein
+ */
+#define BENCH_MAX_SYNTHETIC_ATOMS 1000000
+/**
+ * represents the ratio between the sizes of consecutive synthetic benchmark proteins
+ */
+#define BENCH_SYNTHETIC_SCALE 10
+/**
+ * represents the gap between the copies of the protein a synthetic protein is built from
+ */
+#define BENCH_COPY_MARGIN 5.0
+/**
+ * represents the num of distinct serial numbers in the ATOM lines of a synthetic protein
+ */
+#define BENCH_SERIAL_NUMBERS 100000
 
 
 //-----------ERRORS SYNTAX-------------------------------------------------------------------------
 /**
- * macro that prints an 0 error msg to the stderr.
+ * macro that prints an 0 error msg to <stream>.
  * error 0 is to clarify the correct usage
  */
-#define USAGE_ERR fprintf(stderr, "Usage: AnalyzeProtein <pdb1> <pdb2> ...\n")
+#define USAGE_ERR(stream) fprintf(stream, "Usage: AnalyzeProtein [--dmax=<hull|brute|check>] "\
+                                  "[--jobs=<n>] [--stream] [--cache] [--contacts=<cutoff>] "\
+                                  "[--bench] <pdb1> <pdb2> ...\n")
 /**
- * macro that prints an 4 error msg to the stderr.
+ * macro that prints an 4 error msg to <stream>.
  * error 1 is to notify that an error occurred in opening one of the files
  * (the file that is passed as a param)
  */
-#define OPEN_FILE_ERR(fileName) fprintf(stderr, "Error opening file %s.\n", fileName)
+#define OPEN_FILE_ERR(stream, fileName) fprintf(stream, "Error opening file %s.\n", fileName)
 /**
- * macro that prints an 2 error msg to the stderr.
+ * macro that prints an 2 error msg to <stream>.
  * error 2 is to notify that a pdb file with no atoms was submitted.
  */
-#define NO_ATOMS_ERR(fileName) fprintf(stderr, "Error - 0 atoms were found in the file %s.\n",\
-                                            fileName)
+#define NO_ATOMS_ERR(stream, fileName) fprintf(stream, \
+                                       "Error - 0 atoms were found in the file %s.\n", fileName)
 /**
- * macro that prints an 3 error msg to the stderr.
+ * macro that prints an 3 error msg to <stream>.
  * error 3 is to notify when a valid atom line is shorter then the minimal value declared
  * (i.e: in MIN_CHARS_IN_ATOM_LINE)
  */
-#define LINE_LENGTH_ERR(len) fprintf(stderr, "ATOM line is too short: %zd characters.\n", len)
+#define LINE_LENGTH_ERR(stream, len) fprintf(stream, "ATOM line is too short: %zd characters.\n",\
+                                             len)
+/**
+ * macro that prints an 4 error msg to <stream>.
+ * error 4 is to notify that a memory allocation failed.
+ */
+#define MEM_ALLOC_ERR(stream) fprintf(stream, "Error in memory allocation.\n")
+/**
+ * macro that prints a warning to <stream> when the hull and the brute force Dmax disagree
+ * (see: DMAX_CHECK mode).
+ */
+#define DMAX_MISMATCH_WARN(stream, fileName, hull, brute) fprintf(stream, \
+                    "Warning - Dmax mismatch in %s: hull %.3f, brute force %.3f.\n",\
+                    fileName, hull, brute)
 
 //---------------------SYNTAX TO COMPARE-----------------------------------------------------
 /**
  * represents a valid atom line prefix
  */
 #define ATOM_PREFIX "ATOM  "
+/**
+ * represents the option that selects the Dmax engine (see DMaxMode)
+ */
+#define DMAX_OPTION "--dmax="
+/**
+ * represents the option that sets the number of files analyzed in parallel (see FilePool)
+ */
+#define JOBS_OPTION "--jobs="
+/**
+ * represents the option that selects the bounded memory analysis (see streamPDBFile)
+ */
+#define STREAM_OPTION "--stream"
+/**
+ * represents the option that reads and writes the binary sidecar caches (see readPDBFileCached)
+ */
+#define CACHE_OPTION "--cache"
+/**
+ * represents the option that counts the contacts within a cutoff (see calculateContacts)
+ */
+#define CONTACTS_OPTION "--contacts="
+/**
+ * represents the option that benchmarks the analysis (see runBenchmarks)
+ */
+#define BENCH_OPTION "--bench"
+/**
+ * represents the format of the ATOM lines of a synthetic protein (serial number, residue
+ * number, x, y and z), see ATOM_PREFIX, X_START, Y_START and Z_START
+ */
+#define SYNTHETIC_ATOM_LINE "ATOM  %5zd  CA  ALA A%4zd    %8.3f%8.3f%8.3f  1.00  0.00           C\n"
+/**
+ * represents the magic that every sidecar cache starts with (see CacheHeader)
+ */
+#define CACHE_MAGIC "APCACHE"
+/**
+ * represents the suffix that is appended to a PDB file's name to name its sidecar cache
+ */
+#define CACHE_SUFFIX ".apc"
+/**
+ * represents the suffix of the temporary file a sidecar cache is written to (see mkstemp)
+ */
+#define CACHE_TEMP_SUFFIX ".XXXXXX"
+
+//---------------------TYPES----------------------------------------------------------------
+/**
+ * represents the engine used to compute Dmax:
+ * DMAX_HULL: reduces the atoms to their convex hull, and searches the pairs of hull vertices.
+ * DMAX_BRUTE: the reference O(n^2) search over all the pairs of atoms.
+ * DMAX_CHECK: computes both, and warns (to the stderr) when they disagree.
+ */
+typedef enum DMaxMode
+{
+    DMAX_HULL,
+    DMAX_BRUTE,
+    DMAX_CHECK
+}DMaxMode;
 
+/**
+ * represents the program's options (parsed from the arguments that start with "--").
+ * dMaxMode: the engine used to compute Dmax.
+ * numOfJobs: the number of files analyzed in parallel (0: one per online core).
+ * stream: 1 to analyze the files in bounded memory (see streamPDBFile), 0 otherwise.
+ * cache: 1 to read and write the sidecar caches of the files (see readPDBFileCached), 0 otherwise.
+ * contactCutoff: the distance within which atoms are in contact (0: contacts are not counted).
+ * bench: 1 to benchmark the analysis instead of printing it (see runBenchmarks), 0 otherwise.
+ * numOfDMaxThreads: the number of threads every brute force Dmax search is split among (set by
+ *                   analyzeFiles from the cores that are left for every file).
+ */
+typedef struct Options
+{
+    DMaxMode dMaxMode;
+    size_t numOfJobs;
+    int stream;
+    int cache;
+    double contactCutoff;
+    int bench;
+    size_t numOfDMaxThreads;
+}Options;
 
-//----------------------COMPUTING------------------------------------------------------------------
+/**
+ * represents a growable store of atoms, kept as a structure of arrays:
+ * coord: coord[0], coord[1], coord[2] are the x[], y[] and z[] arrays of the atoms' coordinates,
+ *        each of them aligned to CACHE_LINE_SIZE.
+ * count: the number of atoms in the store.
+ * capacity: the number of atoms the arrays have room for (grows geometrically).
+ */
+typedef struct AtomStore
+{
+    float *coord[DIMENSIONS];
+    size_t count;
+    size_t capacity;
+}AtomStore;
+
+/**
+ * represents the running sums that the center of gravity and the ionic radius are computed from.
+ * the coordinates are shifted by <origin> (the first atom accumulated) before they are summed,
+ * which keeps the sums small and the ionic radius accurate for proteins far from (0, 0, 0).
+ * origin: the shifting origin.
+ * sum: the sums of the shifted x, y and z coordinates.
+ * sumOfSquares: the sum of the squared shifted coordinates (of all dimensions).
+ * count: the num of atoms accumulated.
+ */
+typedef struct AtomStats
+{
+    double origin[DIMENSIONS];
+    double sum[DIMENSIONS];
+    double sumOfSquares;
+    size_t count;
+}AtomStats;
+
+/**
+ * represents a uniform grid of cubic cells over the atoms' bounding box (a cell list): the atoms
+ * are sorted by their cell, so the atoms of every cell are stored contiguously.
+ * atoms: the atoms, sorted by their cell.
+ * cellStart: the atoms of cell c are atoms[cellStart[c] .. cellStart[c + 1]) (numOfCells + 1).
+ * dims: the num of cells along every dimension (cell (x, y, z) is c = (z*dims[1] + y)*dims[0] + x).
+ * min: the corner of the bounding box.
+ * cellSize: the edge of the cells.
+ */
+typedef struct AtomGrid
+{
+    AtomStore atoms;
+    size_t *cellStart;
+    size_t dims[DIMENSIONS];
+    double min[DIMENSIONS];
+    double cellSize;
+}AtomGrid;
+
+/**
+ * represents the contacts of a protein: the pairs of atoms within a cutoff of each other.
+ * numOfContacts: the num of pairs.
+ * numOfAtomsInContact: the num of atoms that take part in at least one pair.
+ * maxNeighbors: the largest num of pairs that a single atom takes part in.
+ * sumOfDistances: the sum of the pairs' distances.
+ */
+typedef struct ContactStats
+{
+    size_t numOfContacts;
+    size_t numOfAtomsInContact;
+    size_t maxNeighbors;
+    double sumOfDistances;
+}ContactStats;
+
+/**
+ * represents the phases of the analysis that are timed by the benchmark (see runBenchPhase).
+ */
+typedef enum BenchPhase
+{
+    BENCH_READ,
+    BENCH_READ_MAPPED,
+    BENCH_CENTER_OF_GRAVITY,
+    BENCH_IONIC_RADIUS,
+    BENCH_DMAX,
+    BENCH_NUM_OF_PHASES
+}BenchPhase;
+
+/**
+ * represents a protein that is benchmarked.
+ * name: the protein's name in the benchmark's results.
+ * file: the protein's PDB file.
+ * atoms: the atoms read from the file.
+ * options: the program's options (the Dmax engine and threads).
+ * errorNum, lineLen: the reading error (see printError).
+ * sink: receives the phases' results, so they are not optimized away.
+ */
+typedef struct BenchTarget
+{
+    const char *name;
+    FILE *file;
+    AtomStore atoms;
+    const Options *options;
+    int errorNum;
+    size_t lineLen;
+    volatile double sink;
+}BenchTarget;
+
+/**
+ * represents the header of a sidecar cache, which is followed by the packed x[], y[] and z[]
+ * float arrays of the atoms (count floats each). the cache is valid only while the PDB file
+ * it was made from has the recorded size, modification time and content hash.
+ * magic, version, byteOrder: identify the format (see CACHE_MAGIC, CACHE_VERSION and
+ *                            CACHE_BYTE_ORDER).
+ * sourceSize: the size of the PDB file.
+ * sourceMTimeSec, sourceMTimeNSec: the modification time of the PDB file.
+ * sourceHash: the content hash of the PDB file (see hashFileContent).
+ * count: the num of atoms.
+ */
+typedef struct CacheHeader
+{
+    char magic[sizeof(CACHE_MAGIC)];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t sourceSize;
+    int64_t sourceMTimeSec;
+    int64_t sourceMTimeNSec;
+    uint64_t sourceHash;
+    uint64_t count;
+}CacheHeader;
+
+/**
+ * represents a face of a convex hull: a triangle that is ordered counter clockwise when
+ * viewed from outside the hull.
+ * v: the indices of the face's atoms.
+ * normal, offset: the face's plane (the outward unit normal, and normal . v[0]).
+ * outside: the indices of the atoms that lie above the face (its outside set).
+ * farthest: the index (in outside) of the atom that lies farthest above the face.
+ * neighbor: neighbor[k] is the index of the face across the edge v[k] -> v[(k + 1) % 3].
+ * alive: 0 once the face was replaced while expanding the hull, 1 otherwise.
+ */
+typedef struct HullFace
+{
+    size_t v[3];
+    size_t neighbor[3];
+    double normal[DIMENSIONS];
+    double offset;
+    size_t *outside;
+    size_t outsideCount;
+    size_t outsideCapacity;
+    size_t farthest;
+    double farthestDist;
+    int alive;
+}HullFace;
+
+/**
+ * represents a convex hull under construction.
+ * faces: dynamic array of the hull's faces (including faces that are no longer alive).
+ * epsilon: the distance under which an atom is considered to lie on a face.
+ * visible, horizon: scratch dynamic arrays of expandHull (the faces the atom sees, and the
+ *                   edges of the hole they leave, as 3 * face + k for the edge k of the face).
+ * coneOf: coneOf[a] is the new face of the horizon edge that starts at the atom a (scratch of
+ *         expandHull, one per atom).
+ */
+typedef struct Hull
+{
+    HullFace *faces;
+    size_t faceCount;
+    size_t faceCapacity;
+    double epsilon;
+    size_t *visible;
+    size_t visibleCapacity;
+    size_t *horizon;
+    size_t horizonCapacity;
+    size_t *coneOf;
+}Hull;
+
+/**
+ * represents an atom of a planar atom set, in coordinates of the set's plane (see
+ * calculatePlanarHullVertices).
+ * x, y: the coordinates in the plane.
+ * index: the index of the atom.
+ */
+typedef struct PlanarPoint
+{
+    double x;
+    double y;
+    size_t index;
+}PlanarPoint;
+
+/**
+ * represents a PDB file that is parsed by a reader thread while it is being analyzed: the reader
+ * fills the chunks in turns, and the analyzer consumes them in the same order.
+ * file: the file.
+ * chunks: the stores the reader parses the atoms into (STREAM_CHUNK_ATOMS atoms each).
+ * full: full[i] is 1 while chunks[i] waits to be consumed, 0 while the reader may fill it.
+ * finished: 1 once the reader is done (after it marked its last chunk full).
+ * errorNum, lineLen: the reading error (0 or 3) and the length of the problematic line.
+ * lock: guards full, finished and errorNum.
+ * changed: signaled whenever full or finished change.
+ */
+typedef struct AtomStream
+{
+    FILE *file;
+    AtomStore chunks[STREAM_CHUNKS];
+    int full[STREAM_CHUNKS];
+    int finished;
+    int errorNum;
+    size_t lineLen;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+}AtomStream;
+
+/**
+ * represents the analysis of one of the files on the command line.
+ * fileName: the file to analyze.
+ * output, outputSize: the analyze results (what goes to the stdout), in a memory buffer.
+ * errors, errorsSize: the error msgs (what goes to the stderr), in a memory buffer.
+ * failed: 1 if the file could not be analyzed, 0 otherwise.
+ * done: 1 once output, errors and failed are set.
+ */
+typedef struct FileJob
+{
+    const char *fileName;
+    char *output;
+    size_t outputSize;
+    char *errors;
+    size_t errorsSize;
+    int failed;
+    int done;
+}FileJob;
+
+/**
+ * represents a pool of worker threads that analyze the files on the command line: each worker
+ * takes the next job that nobody took yet, while the main thread prints the finished jobs in
+ * the order of the command line.
+ * jobs: the jobs, in the order of the command line.
+ * nextJob: the index of the next job to take.
+ * options: the program's options.
+ * lock: guards nextJob and the jobs' done fields.
+ * jobDone: signaled whenever a job is done.
+ */
+typedef struct FilePool
+{
+    FileJob *jobs;
+    size_t numOfJobs;
+    size_t nextJob;
+    const Options *options;
+    pthread_mutex_t lock;
+    pthread_cond_t jobDone;
+}FilePool;
+
+/**
+ * represents the tile pairs that are left to one of the threads of the brute force Dmax search
+ * (see TileSearch): the owner takes pairs from the front, and threads that ran out of pairs
+ * steal half of the remaining pairs from the back.
+ * next, end: the range of the (linear) indices of the pairs that are left.
+ * lock: guards next and end.
+ */
+typedef struct TileRange
+{
+    size_t next;
+    size_t end;
+    pthread_mutex_t lock;
+}TileRange;
+
+/**
+ * represents a brute force Dmax search that is split among threads: the atoms are split into
+ * tiles of DMAX_TILE_ATOMS atoms, and every pair of tiles (including a tile with itself) is
+ * a unit of work.
+ * atoms: the protein atoms.
+ * numOfTiles: the num of tiles.
+ * ranges: ranges[i] is the range of tile pairs that is left to thread i.
+ * numOfThreads: the num of threads (and ranges).
+ */
+typedef struct TileSearch
+{
+    const AtomStore *atoms;
+    size_t numOfTiles;
+    TileRange *ranges;
+    size_t numOfThreads;
+}TileSearch;
+
+/**
+ * represents one of the threads of a brute force Dmax search.
+ * search: the search.
+ * id: the index of the thread's range (in search->ranges).
+ * max: the largest squared distance the thread found.
+ */
+typedef struct TileWorker
+{
+    TileSearch *search;
+    size_t id;
+    double max;
+}TileWorker;
+
+//----------------------PROTOTYPES-----------------------------------------------------------------
+void printErrorAndExit(int errorNum, FILE *const file, const char * const fileName, \
+                       const size_t len);
 
 
+//----------------------ATOM STORE-----------------------------------------------------------------
+/**
+ * initializes an empty atom store (no memory is allocated until the first atom is added).
+ * @param atoms: the store.
+ */
+void initAtomStore(AtomStore *const atoms)
+    {
+        size_t d;
+        for (d = 0; d < DIMENSIONS; ++d)
+        {
+            atoms->coord[d] = NULL;
+        }
+        atoms->count = atoms->capacity = 0;
+    }
 
 /**
- * computes and returns the average x, y or z value (determined by the idx parameter) value
- * of the atoms in the supplied array called atoms.
- * @param atoms: 2-dimensional array of size: [<numOfAtoms>][DIMENSIONS]
- * @param numOfAtoms: The atoms array's size
- * @param idx: natural number between 0 and 2, representing the atom's x, y or z value.
- * @return The average value of the atoms x, y or z value (determined by the idx parameter).
+ * makes sure that <atoms> has room for at least <capacity> atoms (keeps the stored atoms).
+ * @param atoms: the store.
+ * @param capacity: the number of atoms to make room for.
  */
-float centerOfGravityHelper(const float atoms[][DIMENSIONS], const size_t numOfAtoms, \
-                            const size_t idx)
+void reserveAtomStore(AtomStore *const atoms, const size_t capacity)
     {
-        size_t i;
-        float sum = 0;
-        for (i = 0; i < numOfAtoms; ++i)
+        if (capacity <= atoms->capacity)
         {
-            sum += atoms[i][idx];
+            return;
         }
-        return sum / numOfAtoms;
+        size_t d;
+        for (d = 0; d < DIMENSIONS; ++d)
+        {
+            void *newCoord = NULL;
+            if (posix_memalign(&newCoord, CACHE_LINE_SIZE, capacity * sizeof(float)) != 0)
+            {
+                printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+            }
+            if (atoms->count > 0)
+            {
+                memcpy(newCoord, atoms->coord[d], atoms->count * sizeof(float));
+            }
+            free(atoms->coord[d]);
+            atoms->coord[d] = (float *)newCoord;
+        }
+        atoms->capacity = capacity;
     }
 
 /**
- * computes the atoms center of gravity and store the result in the supplied  centerOfGravity array.
- * @param atoms: 2-dimensional array of size: [<numOfAtoms>][<DIMENSIONS>]
- * @param numOfAtoms: The atoms array's size
- * @param centerOfGravity: Array of size <DIMENSIONS>.
+ * adds an atom to the end of <atoms>, doubling the store's capacity when it is full.
+ * @param atoms: the store.
+ * @param x, y, z: the atom's coordinates.
  */
-void calculateCenterOfGravity(const float atoms[][DIMENSIONS], const size_t numOfAtoms, \
-                              float centerOfGravity[])
+void addAtom(AtomStore *const atoms, const float x, const float y, const float z)
     {
-        size_t i;
-        for (i = 0; i < DIMENSIONS; ++i)
+        if (atoms->count == atoms->capacity)
         {
-            centerOfGravity[i] = centerOfGravityHelper(atoms, numOfAtoms, i);
+            reserveAtomStore(atoms, atoms->capacity ? 2 * atoms->capacity : \
+                                    ATOM_STORE_INITIAL_CAPACITY);
         }
+        atoms->coord[0][atoms->count] = x;
+        atoms->coord[1][atoms->count] = y;
+        atoms->coord[2][atoms->count] = z;
+        ++atoms->count;
     }
 
-    /**
-     * Computes the distance between the 2 given points of <dimension> dimension.
-     * @param point1 : a <dimension>-dimensional point
-     * @param points2 : a <dimension>-dimensional point
-     * @param dimension : the dimension of the supplied points
-     * @return the distance between the 2 supplied points
-     */
-    double distanceBetweenPoints(const float point1[], const float points2[], \
-                                 const size_t dimension)
+/**
+ * frees the memory of <atoms>, and leaves it empty.
+ * @param atoms: the store.
+ */
+void freeAtomStore(AtomStore *const atoms)
+    {
+        size_t d;
+        for (d = 0; d < DIMENSIONS; ++d)
+        {
+            free(atoms->coord[d]);
+        }
+        initAtomStore(atoms);
+    }
+
+//----------------------COMPUTING------------------------------------------------------------------
+
+/**
+ * initializes empty statistics.
+ * @param stats: the statistics.
+ */
+void initAtomStats(AtomStats *const stats)
+    {
+        size_t d;
+        for (d = 0; d < DIMENSIONS; ++d)
+        {
+            stats->origin[d] = 0;
+            stats->sum[d] = 0;
+        }
+        stats->sumOfSquares = 0;
+        stats->count = 0;
+    }
+
+/**
+ * represents a kernel of accumulateAtomStats, that accumulates a prefix of the atoms' range.
+ * @param coord: the coordinate array (x[], y[] or z[]) of the atoms.
+ * @param begin, end: the range of atoms to accumulate.
+ * @param origin: the coordinate of the shifting origin.
+ * @param sum: receives the sum of the shifted coordinates.
+ * @param sumOfSquares: receives the sum of the squared shifted coordinates.
+ * @return the index of the first atom that was not accumulated (the tail left for scalar code).
+ */
+typedef size_t (*AccumulateKernel)(const float *const coord, const size_t begin, \
+                                   const size_t end, const double origin, double *const sum, \
+                                   double *const sumOfSquares);
+
+/**
+ * the scalar kernel of accumulateAtomStats: leaves all the atoms to the scalar code.
+ * @param coord: the coordinate array (x[], y[] or z[]) of the atoms.
+ * @param begin: the first atom to accumulate.
+ * @return <begin>.
+ */
+size_t accumulateCoordinateScalar(const float *const coord, const size_t begin, \
+                                  const size_t end, const double origin, double *const sum, \
+                                  double *const sumOfSquares)
+    {
+        (void)coord, (void)end, (void)origin, (void)sum, (void)sumOfSquares;
+        return begin;
+    }
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+/**
+ * the AVX2 kernel of accumulateAtomStats: every coordinate array is streamed once, 4 atoms at
+ * a time, whose shifted coordinates are widened to doubles before they are summed and squared.
+ * @param coord: the coordinate array (x[], y[] or z[]) of the atoms.
+ * @param begin, end: the range of atoms to accumulate.
+ * @param origin: the coordinate of the shifting origin.
+ * @param sum: receives the sum of the shifted coordinates.
+ * @param sumOfSquares: receives the sum of the squared shifted coordinates.
+ * @return the index of the first atom that was not accumulated (the tail left for scalar code).
+ */
+__attribute__((target("avx2")))
+size_t accumulateCoordinateAvx2(const float *const coord, const size_t begin, const size_t end, \
+                                const double origin, double *const sum, double *const sumOfSquares)
     {
+        const __m256d shift = _mm256_set1_pd(origin);
+        __m256d sums = _mm256_setzero_pd(), squares = _mm256_setzero_pd();
         size_t i;
-        double val = 0;
-        for (i = 0; i < dimension; ++i)
+        for (i = begin; i + SIMD_ATOMS <= end; i += SIMD_ATOMS)
+        {
+            const __m256d value = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(&coord[i])), shift);
+            sums = _mm256_add_pd(sums, value);
+            squares = _mm256_add_pd(squares, _mm256_mul_pd(value, value));
+        }
+        double lanes[SIMD_ATOMS];
+        size_t lane;
+        _mm256_storeu_pd(lanes, sums);
+        for (lane = 0; lane < SIMD_ATOMS; ++lane)
         {
-            val += pow(point1[i] - points2[i], 2);
+            *sum += lanes[lane];
         }
-        return sqrt(val);
+        _mm256_storeu_pd(lanes, squares);
+        for (lane = 0; lane < SIMD_ATOMS; ++lane)
+        {
+            *sumOfSquares += lanes[lane];
+        }
+        return i;
     }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
 /**
- * Computes and returns the ionic radius of the atoms provided.
- * @param atoms: 2-dimensional array of size: [<numOfAtoms>][<DIMENSIONS>].
- * @param numOfAtoms: The atoms array's size.
- * @param centerOfGravity: Array of size <DIMENSIONS>.
- * @return The ionic radius of the atoms provided.
+ * the NEON kernel of accumulateAtomStats: every coordinate array is streamed once, 4 atoms at
+ * a time, whose shifted coordinates are widened to doubles before they are summed and squared.
+ * @param coord: the coordinate array (x[], y[] or z[]) of the atoms.
+ * @param begin, end: the range of atoms to accumulate.
+ * @param origin: the coordinate of the shifting origin.
+ * @param sum: receives the sum of the shifted coordinates.
+ * @param sumOfSquares: receives the sum of the squared shifted coordinates.
+ * @return the index of the first atom that was not accumulated (the tail left for scalar code).
  */
-double calculateIonicRadius(const float atoms[][DIMENSIONS], const size_t numOfAtoms, \
-                            const float centerOfGravity[])
+size_t accumulateCoordinateNeon(const float *const coord, const size_t begin, const size_t end, \
+                                const double origin, double *const sum, double *const sumOfSquares)
     {
+        const float64x2_t shift = vdupq_n_f64(origin);
+        float64x2_t sums = vdupq_n_f64(0), squares = vdupq_n_f64(0);
         size_t i;
-        double sum = 0;
-        for (i = 0; i < numOfAtoms; ++i)
+        for (i = begin; i + SIMD_ATOMS <= end; i += SIMD_ATOMS)
         {
-                const double distFromGravityCenter = \
-                            distanceBetweenPoints(atoms[i], centerOfGravity, DIMENSIONS);
-                sum += pow(distFromGravityCenter, 2);
+            const float32x4_t value = vld1q_f32(&coord[i]);
+            const float64x2_t low = vsubq_f64(vcvt_f64_f32(vget_low_f32(value)), shift);
+            const float64x2_t high = vsubq_f64(vcvt_high_f64_f32(value), shift);
+            sums = vaddq_f64(sums, vaddq_f64(low, high));
+            squares = vfmaq_f64(vfmaq_f64(squares, low, low), high, high);
         }
-        const double average = (sum / numOfAtoms);
-        return sqrt(average);
+        *sum += vaddvq_f64(sums);
+        *sumOfSquares += vaddvq_f64(squares);
+        return i;
     }
+#endif
 
-    /**
-     * calculate and returns the DMax value of the protein described as atoms[].
-     * @param atoms : the protein atoms.
-     * @param numOfAtoms : the number of atoms in the supplied atoms array
-     * @return DMax value of the protein described as atoms[].
-     */
-double calculateDMax(const float atoms[][DIMENSIONS], const size_t numOfAtoms)
+/**
+ * the kernel of accumulateAtomStats (see selectKernels).
+ */
+#if defined(__ARM_NEON) && defined(__aarch64__)
+AccumulateKernel accumulateCoordinate = accumulateCoordinateNeon;
+#else
+AccumulateKernel accumulateCoordinate = accumulateCoordinateScalar;
+#endif
+
+/**
+ * adds the atoms in indices [begin, end) of <atoms> to <stats>, in a single streaming pass
+ * over the coordinates (vectorized where the cpu supports it, see accumulateCoordinate).
+ * the first atom ever accumulated becomes the stats' origin (see AtomStats).
+ * @param stats: the statistics.
+ * @param atoms: the protein atoms (see AtomStore).
+ * @param begin, end: the range of atoms to accumulate.
+ */
+void accumulateAtomStats(AtomStats *const stats, const AtomStore *const atoms, \
+                         const size_t begin, const size_t end)
     {
-        size_t i, j;
-        double max = 0;
-        for (i = 0; i < numOfAtoms; ++i)
+        size_t d, i;
+        if (begin >= end)
+        {
+            return;
+        }
+        if (stats->count == 0)
         {
-            for (j = i + 1; j < numOfAtoms; ++j)
+            for (d = 0; d < DIMENSIONS; ++d)
             {
-                const double distBetweenPoints = \
-                distanceBetweenPoints(atoms[i], atoms[j], DIMENSIONS);
-                max = fmax(max, distBetweenPoints);
+                stats->origin[d] = atoms->coord[d][begin];
             }
         }
-        return max;
+        for (d = 0; d < DIMENSIONS; ++d)
+        {
+            const float *const coord = atoms->coord[d];
+            double sum = 0, sumOfSquares = 0;
+            for (i = accumulateCoordinate(coord, begin, end, stats->origin[d], &sum, \
+                                          &sumOfSquares); i < end; ++i)
+            {
+                const double value = coord[i] - stats->origin[d];
+                sum += value;
+                sumOfSquares += value * value;
+            }
+            stats->sum[d] += sum;
+            stats->sumOfSquares += sumOfSquares;
+        }
+        stats->count += end - begin;
     }
 
+/**
+ * computes the statistics of all the atoms in <atoms>.
+ * @param atoms: the protein atoms (see AtomStore).
+ * @param stats: receives the statistics.
+ */
+void calculateAtomStats(const AtomStore *const atoms, AtomStats *const stats)
+    {
+        initAtomStats(stats);
+        accumulateAtomStats(stats, atoms, 0, atoms->count);
+    }
 
-//-----------------------------------PRINTING--------------------------------------------------
 /**
- * prints an informative error msg and exits neatly (i.e: closes open file is exists)
- * with failure code.
- * @param errorNum: number from 0 to 3 that correspond to the errors described as macros
- *                  (see documentation).
- * @param file: pointer to the file (NULL if doesn't exist).
- * @param fileName: the file name (NULL if doesn't exist).
- * @param len: the length of the problematic in the file (NULL if doesn't exist).
- * @param coordinate: the problematic coordinate (string rep.) in the file (NULL if doesn't exist).
+ * computes the center of gravity of the accumulated atoms.
+ * @param stats: non empty statistics.
+ * @param centerOfGravity: Array of size <DIMENSIONS>.
  */
-void printErrorAndExit(int errorNum, FILE *const file, const char * const fileName, \
-                       const size_t len)
+void centerOfGravityOfStats(const AtomStats *const stats, float centerOfGravity[])
     {
-        switch(errorNum)
+        size_t d;
+        for (d = 0; d < DIMENSIONS; ++d)
         {
-            //clarify the correct usage:
-            case(0):
-                USAGE_ERR;
-                break;
-
-            //notify that an error occurred in opening the file that is passed as a param:
-            case(1):
-                OPEN_FILE_ERR(fileName);
-                break;
-
-            //notify that a pdb file with no atoms was submitted:
-            case(2):
-                NO_ATOMS_ERR(fileName);
-                fclose(file);
-                break;
-
-            //notify when a valid atom line is shorter then the minimal value declared
-            case(3):
-                LINE_LENGTH_ERR(len);
-                fclose(file);
-                break;
-
-            default:
-                break;
+            centerOfGravity[d] = (float)(stats->origin[d] + stats->sum[d] / stats->count);
         }
-    exit(EXIT_FAILURE);
     }
 
 /**
- * prints the center of gravity value of the protein.
- * @param atoms: the protein atoms.
- * @param numOfAtoms: the number of atoms in the supplied atoms array
- * @param centerOfGravity: Array of size <DIMENSIONS>.
+ * computes the ionic radius of the accumulated atoms: the mean squared distance from the
+ * center of gravity is the mean squared (shifted) coordinate minus the squared (shifted) mean.
+ * @param stats: non empty statistics.
+ * @return The ionic radius of the accumulated atoms.
  */
-void printCenterOfGravity(const float atoms[][DIMENSIONS], const size_t numOfAtoms,\
-                          float centerOfGravity[])
+double ionicRadiusOfStats(const AtomStats *const stats)
     {
-        calculateCenterOfGravity(atoms, numOfAtoms, centerOfGravity);
-        printf("Cg = %.3f %.3f %.3f\n" , centerOfGravity[0], centerOfGravity[1], centerOfGravity[2]);
+        double meanSquare = stats->sumOfSquares / stats->count;
+        size_t d;
+        for (d = 0; d < DIMENSIONS; ++d)
+        {
+            const double mean = stats->sum[d] / stats->count;
+            meanSquare -= mean * mean;
+        }
+        return sqrt(fmax(meanSquare, 0));
     }
 
 /**
- * prints the ionic radius value of the protein
- * @param atoms: the protein atoms.
- * @param numOfAtoms : the number of atoms in the supplied atoms array
+ * computes the atoms center of gravity and store the result in the supplied  centerOfGravity array.
+ * @param atoms: the protein atoms (see AtomStore).
  * @param centerOfGravity: Array of size <DIMENSIONS>.
  */
-void printIonicRadius(const float atoms[][DIMENSIONS], const size_t numOfAtoms,\
-                      const float centerOfGravity[])
+void calculateCenterOfGravity(const AtomStore *const atoms, float centerOfGravity[])
     {
-        double ionicRadius = calculateIonicRadius(atoms, numOfAtoms, centerOfGravity);
-        printf("Rg = %.3f\n", ionicRadius);
+        AtomStats stats;
+        calculateAtomStats(atoms, &stats);
+        centerOfGravityOfStats(&stats, centerOfGravity);
     }
+
 /**
- * prints the Dmax value of the protein
- * @param atoms: the protein atoms.
- * @param numOfAtoms : the number of atoms in the supplied atoms array
+ * Computes and returns the ionic radius of the atoms provided.
+ * @param atoms: the protein atoms (see AtomStore).
+ * @return The ionic radius of the atoms provided.
  */
-void printDMax(const float atoms[][DIMENSIONS], const size_t numOfAtoms)
+double calculateIonicRadius(const AtomStore *const atoms)
     {
-        double dMax = calculateDMax(atoms, numOfAtoms);
-        printf("Dmax = %.3f\n", dMax);
+        AtomStats stats;
+        calculateAtomStats(atoms, &stats);
+        return ionicRadiusOfStats(&stats);
     }
+
 /**
- * prints the protein's analyze results
- * @param fileName: the file name .
  * @param atoms: the protein atoms.
- * @param numOfAtoms : the number of atoms in the supplied atoms array
+ * @param a: index of an atom.
+ * @param b: index of an atom.
+ * @return the squared distance between the atoms in index <a> and <b>.
  */
-void printProteinAnalyze(const char *const fileName, const float atoms[][DIMENSIONS],\
-                         const size_t numOfAtoms)
+double squaredDistance(const AtomStore *const atoms, const size_t a, const size_t b)
     {
-        printf("PDB file %s, %zd atoms were read\n", fileName, numOfAtoms);
-        float centerOfGravity[DIMENSIONS] = {0};
-        printCenterOfGravity(atoms, numOfAtoms , centerOfGravity);
-        printIonicRadius(atoms, numOfAtoms , centerOfGravity);
-        printDMax(atoms, numOfAtoms);
+        const double dx = atoms->coord[0][a] - atoms->coord[0][b];
+        const double dy = atoms->coord[1][a] - atoms->coord[1][b];
+        const double dz = atoms->coord[2][a] - atoms->coord[2][b];
+        return dx * dx + dy * dy + dz * dz;
     }
 
-
-//----------------------READING--------------------------------------------------------------------
+/**
+ * represents a kernel of compareTiles, that compares an atom with a prefix of a range of atoms.
+ * @param atoms: the protein atoms.
+ * @param atom: index of an atom.
+ * @param begin, end: the range of atoms to compare it with.
+ * @param max: the largest squared distance found so far, receives the new one.
+ * @return the index of the first atom that was not compared (the tail left for scalar code).
+ */
+typedef size_t (*DistanceKernel)(const AtomStore *const atoms, const size_t atom, \
+                                 const size_t begin, const size_t end, double *const max);
 
 /**
- * create a new atom from the data in <buff>, and ads it to <atoms> in index <atomCount>.
- * we assume that the data in <buff> is valid (so memcpy and strtof will work correctly)
- * @param atoms: an array to which we add the new atom.
- * @param buff : holds the atom's data.
- * @param atomCount: the index to place the new atom in <atoms>.
+ * the scalar kernel of compareTiles: leaves all the atoms to the scalar code.
+ * @param begin: the first atom to compare with.
+ * @return <begin>.
  */
-void createAtom(float atoms[][DIMENSIONS], const char *const buff, const size_t atomCount)
+size_t maxSquaredDistanceFromScalar(const AtomStore *const atoms, const size_t atom, \
+                                    const size_t begin, const size_t end, double *const max)
     {
-        char xAsChar[COORDINATE_SIZE + 1] = {'\0'}, yAsChar[COORDINATE_SIZE + 1] = {'\0'},\
-                    zAsChar[COORDINATE_SIZE + 1] = {'\0'};
-        memcpy(xAsChar, &buff[X_START], COORDINATE_SIZE);
-        memcpy(yAsChar, &buff[Y_START], COORDINATE_SIZE);
-        memcpy(zAsChar, &buff[Z_START], COORDINATE_SIZE);
-        atoms[atomCount][0] = strtof(xAsChar, NULL);
-        atoms[atomCount][1] = strtof(yAsChar, NULL);
-        atoms[atomCount][2] = strtof(zAsChar, NULL);
+        (void)atoms, (void)atom, (void)end, (void)max;
+        return begin;
     }
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
 /**
- * reads a PDB file and returns the number of atoms that were read from it,
- * and were stored in <atoms>.
- * @param file: a valid pointer to the file.
- * @param atoms: an array.
- * @return: the number of atoms read in the file.
+ * the AVX2 kernel of compareTiles: compares the atom in index <atom> with 4 atoms at a time,
+ * whose coordinate differences are widened to doubles before they are squared.
+ * @param atoms: the protein atoms.
+ * @param atom: index of an atom.
+ * @param begin, end: the range of atoms to compare it with.
+ * @param max: the largest squared distance found so far, receives the new one.
+ * @return the index of the first atom that was not compared (the tail left for scalar code).
  */
-size_t readPDBFile(FILE *const file, float atoms[][DIMENSIONS])
+__attribute__((target("avx2")))
+size_t maxSquaredDistanceFromAvx2(const AtomStore *const atoms, const size_t atom, \
+                                  const size_t begin, const size_t end, double *const max)
+    {
+        __m128 origin[DIMENSIONS];
+        __m256d maxes = _mm256_set1_pd(*max);
+        size_t d, i;
+        for (d = 0; d < DIMENSIONS; ++d)
+        {
+            origin[d] = _mm_set1_ps(atoms->coord[d][atom]);
+        }
+        for (i = begin; i + SIMD_ATOMS <= end; i += SIMD_ATOMS)
+        {
+            __m256d squares = _mm256_setzero_pd();
+            for (d = 0; d < DIMENSIONS; ++d)
+            {
+                const __m256d diff = _mm256_cvtps_pd(_mm_sub_ps(origin[d], \
+                                                                _mm_loadu_ps(&atoms->coord[d][i])));
+                squares = _mm256_add_pd(squares, _mm256_mul_pd(diff, diff));
+            }
+            maxes = _mm256_max_pd(maxes, squares);
+        }
+        double lanes[SIMD_ATOMS];
+        size_t lane;
+        _mm256_storeu_pd(lanes, maxes);
+        for (lane = 0; lane < SIMD_ATOMS; ++lane)
+        {
+            *max = fmax(*max, lanes[lane]);
+        }
+        return i;
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+/**
+ * the NEON kernel of compareTiles: compares the atom in index <atom> with 4 atoms at a time,
+ * whose coordinate differences are widened to doubles before they are squared.
+ * @param atoms: the protein atoms.
+ * @param atom: index of an atom.
+ * @param begin, end: the range of atoms to compare it with.
+ * @param max: the largest squared distance found so far, receives the new one.
+ * @return the index of the first atom that was not compared (the tail left for scalar code).
+ */
+size_t maxSquaredDistanceFromNeon(const AtomStore *const atoms, const size_t atom, \
+                                  const size_t begin, const size_t end, double *const max)
+    {
+        float32x4_t origin[DIMENSIONS];
+        float64x2_t maxes = vdupq_n_f64(*max);
+        size_t d, i;
+        for (d = 0; d < DIMENSIONS; ++d)
+        {
+            origin[d] = vdupq_n_f32(atoms->coord[d][atom]);
+        }
+        for (i = begin; i + SIMD_ATOMS <= end; i += SIMD_ATOMS)
+        {
+            float64x2_t low = vdupq_n_f64(0), high = vdupq_n_f64(0);
+            for (d = 0; d < DIMENSIONS; ++d)
+            {
+                const float32x4_t diff = vsubq_f32(origin[d], vld1q_f32(&atoms->coord[d][i]));
+                const float64x2_t lowDiff = vcvt_f64_f32(vget_low_f32(diff));
+                const float64x2_t highDiff = vcvt_high_f64_f32(diff);
+                low = vaddq_f64(low, vmulq_f64(lowDiff, lowDiff));
+                high = vaddq_f64(high, vmulq_f64(highDiff, highDiff));
+            }
+            maxes = vmaxq_f64(maxes, vmaxq_f64(low, high));
+        }
+        *max = vmaxvq_f64(maxes);
+        return i;
+    }
+#endif
+
+/**
+ * the kernel of compareTiles (see selectKernels).
+ */
+#if defined(__ARM_NEON) && defined(__aarch64__)
+DistanceKernel maxSquaredDistanceFrom = maxSquaredDistanceFromNeon;
+#else
+DistanceKernel maxSquaredDistanceFrom = maxSquaredDistanceFromScalar;
+#endif
+
+/**
+ * picks the widest kernels that the cpu supports (the build's default target may not have them,
+ * so they are compiled for their own target, and only run where the cpu has it).
+ */
+void selectKernels()
+    {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        if (__builtin_cpu_supports("avx2"))
+        {
+            accumulateCoordinate = accumulateCoordinateAvx2;
+            maxSquaredDistanceFrom = maxSquaredDistanceFromAvx2;
+        }
+#endif
+    }
+
+/**
+ * compares every pair of atoms that has one atom in tile <a> and the other in tile <b>
+ * (see TileSearch).
+ * @param atoms: the protein atoms.
+ * @param a, b: indices of tiles, a <= b.
+ * @param max: the largest squared distance found so far.
+ * @return the largest of <max> and the squared distances between the tiles' atoms.
+ */
+double compareTiles(const AtomStore *const atoms, const size_t a, const size_t b, double max)
+    {
+        const size_t aEnd = (a + 1) * DMAX_TILE_ATOMS;
+        const size_t bBegin = b * DMAX_TILE_ATOMS;
+        const size_t bEnd = (bBegin + DMAX_TILE_ATOMS < atoms->count) ? \
+                            bBegin + DMAX_TILE_ATOMS : atoms->count;
+        size_t i, j;
+        for (i = a * DMAX_TILE_ATOMS; i < aEnd && i < atoms->count; ++i)
+        {
+            const size_t begin = (a == b) ? i + 1 : bBegin;
+            for (j = maxSquaredDistanceFrom(atoms, i, begin, bEnd, &max); j < bEnd; ++j)
+            {
+                max = fmax(max, squaredDistance(atoms, i, j));
+            }
+        }
+        return max;
+    }
+
+/**
+ * finds the pair of tiles that the linear index <pair> stands for: the pairs are ordered by
+ * their first tile, and then by their second tile.
+ * @param pair: the linear index of a pair of tiles.
+ * @param numOfTiles: the num of tiles.
+ * @param a, b: receive the indices of the pair's tiles, a <= b.
+ */
+void tilePairOf(const size_t pair, const size_t numOfTiles, size_t *const a, size_t *const b)
+    {
+        // the pairs of tile t start at t * numOfTiles - t * (t - 1) / 2:
+        size_t low = 0, high = numOfTiles - 1;
+        while (low < high)
+        {
+            const size_t mid = (low + high + 1) / 2;
+            if (mid * numOfTiles - mid * (mid - 1) / 2 <= pair)
+            {
+                low = mid;
+            }
+            else
+            {
+                high = mid - 1;
+            }
+        }
+        *a = low;
+        *b = low + (pair - (low * numOfTiles - low * (low - 1) / 2));
+    }
+
+/**
+ * takes the next tile pair of a thread: from the front of its own range, or, once the range is
+ * empty, by stealing half of the pairs left to another thread.
+ * @param worker: the thread.
+ * @param pair: receives the linear index of the pair.
+ * @return 1 if a pair was taken, 0 if no pairs are left to any thread.
+ */
+int takeTilePair(TileWorker *const worker, size_t *const pair)
+    {
+        TileSearch *const search = worker->search;
+        TileRange *const own = &search->ranges[worker->id];
+        pthread_mutex_lock(&own->lock);
+        const int found = (own->next < own->end);
+        if (found)
+        {
+            *pair = own->next++;
+        }
+        pthread_mutex_unlock(&own->lock);
+        if (found)
+        {
+            return 1;
+        }
+        size_t i;
+        for (i = 1; i < search->numOfThreads; ++i)
+        {
+            TileRange *const victim = &search->ranges[(worker->id + i) % search->numOfThreads];
+            size_t begin = 0, end = 0;
+            pthread_mutex_lock(&victim->lock);
+            if (victim->next < victim->end)
+            {
+                end = victim->end;
+                begin = victim->end - (victim->end - victim->next + 1) / 2;
+                victim->end = begin;
+            }
+            pthread_mutex_unlock(&victim->lock);
+            if (begin < end)
+            {
+                pthread_mutex_lock(&own->lock);
+                own->next = begin + 1;
+                own->end = end;
+                pthread_mutex_unlock(&own->lock);
+                *pair = begin;
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+/**
+ * the body of every thread of a brute force Dmax search: compares tile pairs until none is left.
+ * @param arg: the TileWorker (receives the largest squared distance the thread found).
+ * @return NULL.
+ */
+void *tileWorker(void *arg)
+    {
+        TileWorker *const worker = (TileWorker *)arg;
+        const TileSearch *const search = worker->search;
+        size_t pair, a, b;
+        double max = 0;
+        while (takeTilePair(worker, &pair))
+        {
+            tilePairOf(pair, search->numOfTiles, &a, &b);
+            max = compareTiles(search->atoms, a, b, max);
+        }
+        worker->max = max;
+        return NULL;
+    }
+
+    /**
+     * calculate and returns the DMax value of the protein described as atoms[], by comparing
+     * every pair of atoms. this is the reference engine (see DMAX_BRUTE).
+     * the atoms are compared tile by tile (see TileSearch), and the tile pairs are split among
+     * up to <numOfThreads> threads (the calling thread included), which compare squared
+     * distances and take a single square root of the largest of them.
+     * @param atoms : the protein atoms.
+     * @param numOfThreads : the maximal num of threads to split the search among.
+     * @return DMax value of the protein described as atoms[].
+     */
+double calculateDMaxBruteForce(const AtomStore *const atoms, const size_t numOfThreads)
+    {
+        TileSearch search;
+        search.atoms = atoms;
+        search.numOfTiles = (atoms->count + DMAX_TILE_ATOMS - 1) / DMAX_TILE_ATOMS;
+        if (search.numOfTiles == 0)
+        {
+            return 0;
+        }
+        const size_t numOfPairs = search.numOfTiles * (search.numOfTiles + 1) / 2;
+        search.numOfThreads = numOfPairs / MIN_TILE_PAIRS_PER_THREAD;
+        if (search.numOfThreads > numOfThreads)
+        {
+            search.numOfThreads = numOfThreads;
+        }
+        if (search.numOfThreads == 0)
+        {
+            search.numOfThreads = 1;
+        }
+        search.ranges = (TileRange *)malloc(search.numOfThreads * sizeof(TileRange));
+        TileWorker *workers = (TileWorker *)malloc(search.numOfThreads * sizeof(TileWorker));
+        pthread_t *threads = (pthread_t *)malloc(search.numOfThreads * sizeof(pthread_t));
+        if (search.ranges == NULL || workers == NULL || threads == NULL)
+        {
+            printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+        }
+        size_t i;
+        for (i = 0; i < search.numOfThreads; ++i)
+        {
+            search.ranges[i].next = numOfPairs * i / search.numOfThreads;
+            search.ranges[i].end = numOfPairs * (i + 1) / search.numOfThreads;
+            pthread_mutex_init(&search.ranges[i].lock, NULL);
+            workers[i].search = &search;
+            workers[i].id = i;
+            workers[i].max = 0;
+        }
+        for (i = 1; i < search.numOfThreads; ++i)
+        {
+            if (pthread_create(&threads[i], NULL, tileWorker, &workers[i]) != 0)
+            {
+                printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+            }
+        }
+        tileWorker(&workers[0]);
+        double max = workers[0].max;
+        for (i = 1; i < search.numOfThreads; ++i)
+        {
+            pthread_join(threads[i], NULL);
+            max = fmax(max, workers[i].max);
+        }
+        for (i = 0; i < search.numOfThreads; ++i)
+        {
+            pthread_mutex_destroy(&search.ranges[i].lock);
+        }
+        free(threads);
+        free(workers);
+        free(search.ranges);
+        return sqrt(max);
+    }
+
+//----------------------CONVEX HULL----------------------------------------------------------------
+
+/**
+ * computes the signed distance of the atom from the face's plane (positive above the face).
+ * @param face: a hull face.
+ * @param atoms: the protein atoms.
+ * @param atom: index of an atom.
+ * @return the signed distance of the atom in index <atom> from <face>.
+ */
+double distanceFromFace(const HullFace *const face, const AtomStore *const atoms, \
+                        const size_t atom)
+    {
+        return face->normal[0] * atoms->coord[0][atom] + face->normal[1] * atoms->coord[1][atom] + \
+               face->normal[2] * atoms->coord[2][atom] - face->offset;
+    }
+
+/**
+ * appends a new face (a, b, c) to <hull>, and computes its plane.
+ * the face's vertices have to be ordered counter clockwise when viewed from outside the hull.
+ * @param hull: the hull.
+ * @param atoms: the protein atoms.
+ * @param a, b, c: indices of the face's atoms.
+ * @return the index of the new face in the hull's faces array.
+ */
+size_t addHullFace(Hull *const hull, const AtomStore *const atoms, const size_t a, \
+                   const size_t b, const size_t c)
+    {
+        if (hull->faceCount == hull->faceCapacity)
+        {
+            hull->faceCapacity *= 2;
+            hull->faces = (HullFace *)realloc(hull->faces, hull->faceCapacity * sizeof(HullFace));
+            if (hull->faces == NULL)
+            {
+                printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+            }
+        }
+        HullFace *const face = &hull->faces[hull->faceCount];
+        double u[DIMENSIONS], w[DIMENSIONS];
+        size_t i;
+        for (i = 0; i < DIMENSIONS; ++i)
+        {
+            u[i] = (double)atoms->coord[i][b] - atoms->coord[i][a];
+            w[i] = (double)atoms->coord[i][c] - atoms->coord[i][a];
+        }
+        face->normal[0] = u[1] * w[2] - u[2] * w[1];
+        face->normal[1] = u[2] * w[0] - u[0] * w[2];
+        face->normal[2] = u[0] * w[1] - u[1] * w[0];
+        const double length = sqrt(face->normal[0] * face->normal[0] + \
+                                   face->normal[1] * face->normal[1] + \
+                                   face->normal[2] * face->normal[2]);
+        for (i = 0; i < DIMENSIONS; ++i)
+        {
+            // a sliver face (collinear vertices) gets a null plane, so no atom lies above it:
+            face->normal[i] = (length > 0) ? face->normal[i] / length : 0;
+        }
+        face->offset = face->normal[0] * atoms->coord[0][a] + \
+                       face->normal[1] * atoms->coord[1][a] + \
+                       face->normal[2] * atoms->coord[2][a];
+        face->v[0] = a;
+        face->v[1] = b;
+        face->v[2] = c;
+        face->neighbor[0] = face->neighbor[1] = face->neighbor[2] = 0;
+        face->outside = NULL;
+        face->outsideCount = face->outsideCapacity = 0;
+        face->farthest = 0;
+        face->farthestDist = 0;
+        face->alive = 1;
+        return hull->faceCount++;
+    }
+
+/**
+ * adds the atom in index <atom> to the outside set of <face>.
+ * @param face: a hull face.
+ * @param atom: index of an atom that lies above the face.
+ * @param dist: the atom's distance from the face.
+ */
+void addToOutsideSet(HullFace *const face, const size_t atom, const double dist)
+    {
+        if (face->outsideCount == face->outsideCapacity)
+        {
+            face->outsideCapacity = face->outsideCapacity ? 2 * face->outsideCapacity : \
+                                    HULL_INITIAL_CAPACITY;
+            face->outside = (size_t *)realloc(face->outside, \
+                                              face->outsideCapacity * sizeof(size_t));
+            if (face->outside == NULL)
+            {
+                printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+            }
+        }
+        if (dist > face->farthestDist)
+        {
+            face->farthestDist = dist;
+            face->farthest = face->outsideCount;
+        }
+        face->outside[face->outsideCount++] = atom;
+    }
+
+/**
+ * appends <value> to a dynamic array of indices, doubling its capacity when it is full.
+ * @param array: the address of the array.
+ * @param count: the num of indices in the array.
+ * @param capacity: the capacity of the array (at least 1).
+ * @param value: the index to append.
+ */
+void pushIndex(size_t **array, size_t *const count, size_t *const capacity, const size_t value)
+    {
+        if (*count == *capacity)
+        {
+            *capacity *= 2;
+            *array = (size_t *)realloc(*array, *capacity * sizeof(size_t));
+            if (*array == NULL)
+            {
+                printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+            }
+        }
+        (*array)[(*count)++] = value;
+    }
+
+/**
+ * assigns the atom to the outside set of the first face (in index <first> and above) it lies
+ * above. if the atom lies under all those faces, it is inside the hull and is dropped.
+ * @param hull: the hull.
+ * @param atoms: the protein atoms.
+ * @param atom: index of an atom.
+ * @param first: the index of the first face to consider.
+ */
+void assignToFace(Hull *const hull, const AtomStore *const atoms, const size_t atom, \
+                  const size_t first)
+    {
+        size_t f;
+        for (f = first; f < hull->faceCount; ++f)
+        {
+            HullFace *const face = &hull->faces[f];
+            if (face->alive)
+            {
+                const double dist = distanceFromFace(face, atoms, atom);
+                if (dist > hull->epsilon)
+                {
+                    addToOutsideSet(face, atom, dist);
+                    return;
+                }
+            }
+        }
+    }
+
+/**
+ * builds the initial tetrahedron of the hull out of extreme atoms.
+ * @param hull: an empty hull, with its epsilon set.
+ * @param atoms: the protein atoms.
+ * @param simplex: array of size MIN_ATOMS_FOR_HULL, receives the indices of the tetrahedron.
+ * @return 1 on success, 0 if the atoms are degenerate (all lie on a plane, line or point).
+ */
+int buildInitialSimplex(Hull *const hull, const AtomStore *const atoms, size_t simplex[])
+    {
+        size_t extremes[2 * DIMENSIONS] = {0};
+        size_t i, d;
+        // the extreme atoms along each axis:
+        for (i = 1; i < atoms->count; ++i)
+        {
+            for (d = 0; d < DIMENSIONS; ++d)
+            {
+                const float *const coord = atoms->coord[d];
+                extremes[2 * d] = (coord[i] < coord[extremes[2 * d]]) ? i : extremes[2 * d];
+                extremes[2 * d + 1] = (coord[i] > coord[extremes[2 * d + 1]]) ? i : \
+                                      extremes[2 * d + 1];
+            }
+        }
+        // first edge: the farthest pair of extreme atoms.
+        double best = 0;
+        for (d = 0; d < DIMENSIONS; ++d)
+        {
+            const double dist = squaredDistance(atoms, extremes[2 * d], extremes[2 * d + 1]);
+            if (dist > best)
+            {
+                best = dist;
+                simplex[0] = extremes[2 * d];
+                simplex[1] = extremes[2 * d + 1];
+            }
+        }
+        if (sqrt(best) <= hull->epsilon)
+        {
+            return 0;
+        }
+        // third vertex: the atom farthest from the line of the first edge.
+        double dir[DIMENSIONS];
+        for (d = 0; d < DIMENSIONS; ++d)
+        {
+            dir[d] = (double)atoms->coord[d][simplex[1]] - atoms->coord[d][simplex[0]];
+        }
+        best = 0;
+        for (i = 0; i < atoms->count; ++i)
+        {
+            double u[DIMENSIONS];
+            for (d = 0; d < DIMENSIONS; ++d)
+            {
+                u[d] = (double)atoms->coord[d][i] - atoms->coord[d][simplex[0]];
+            }
+            const double cx = u[1] * dir[2] - u[2] * dir[1];
+            const double cy = u[2] * dir[0] - u[0] * dir[2];
+            const double cz = u[0] * dir[1] - u[1] * dir[0];
+            const double dist = cx * cx + cy * cy + cz * cz;
+            if (dist > best)
+            {
+                best = dist;
+                simplex[2] = i;
+            }
+        }
+        if (sqrt(best) / sqrt(squaredDistance(atoms, simplex[0], simplex[1])) <= hull->epsilon)
+        {
+            return 0;
+        }
+        // fourth vertex: the atom farthest from the plane of the first three.
+        const size_t base = addHullFace(hull, atoms, simplex[0], simplex[1], simplex[2]);
+        best = 0;
+        double signedBest = 0;
+        for (i = 0; i < atoms->count; ++i)
+        {
+            const double dist = distanceFromFace(&hull->faces[base], atoms, i);
+            if (fabs(dist) > best)
+            {
+                best = fabs(dist);
+                signedBest = dist;
+                simplex[3] = i;
+            }
+        }
+        hull->faceCount = 0;
+        if (best <= hull->epsilon)
+        {
+            return 0;
+        }
+        // orients the base so that the fourth vertex lies under it:
+        if (signedBest > 0)
+        {
+            const size_t tmp = simplex[1];
+            simplex[1] = simplex[2];
+            simplex[2] = tmp;
+        }
+        addHullFace(hull, atoms, simplex[0], simplex[1], simplex[2]);
+        addHullFace(hull, atoms, simplex[0], simplex[3], simplex[1]);
+        addHullFace(hull, atoms, simplex[1], simplex[3], simplex[2]);
+        addHullFace(hull, atoms, simplex[2], simplex[3], simplex[0]);
+        // links every edge of the tetrahedron to its twin (the reversed edge of another face):
+        size_t f, g, k, j;
+        for (f = 0; f < hull->faceCount; ++f)
+        {
+            for (k = 0; k < 3; ++k)
+            {
+                for (g = 0; g < hull->faceCount; ++g)
+                {
+                    for (j = 0; g != f && j < 3; ++j)
+                    {
+                        if (hull->faces[g].v[j] == hull->faces[f].v[(k + 1) % 3] && \
+                            hull->faces[g].v[(j + 1) % 3] == hull->faces[f].v[k])
+                        {
+                            hull->faces[f].neighbor[k] = g;
+                        }
+                    }
+                }
+            }
+        }
+        return 1;
+    }
+
+/**
+ * expands the hull to contain the farthest atom of <faceIdx>'s outside set:
+ * removes every face the atom sees (found by a breadth first search over the faces' neighbors,
+ * from <faceIdx>), fills the hole with a cone of new faces (one per horizon edge to the atom),
+ * and re-assigns the removed faces' outside sets to the new faces. so, the cost of an expansion
+ * is bounded by the faces it removes and adds, rather than by the size of the hull.
+ * @param hull: the hull.
+ * @param atoms: the protein atoms.
+ * @param faceIdx: index of an alive face with non empty outside set.
+ */
+void expandHull(Hull *const hull, const AtomStore *const atoms, const size_t faceIdx)
+    {
+        const size_t eye = hull->faces[faceIdx].outside[hull->faces[faceIdx].farthest];
+        size_t numOfVisible = 0, numOfHorizon = 0, f, k, j;
+        // the visible faces are marked dead as soon as they are found (the neighbors of the
+        // alive faces are alive, so a dead neighbor is a visible face found earlier):
+        hull->faces[faceIdx].alive = 0;
+        pushIndex(&hull->visible, &numOfVisible, &hull->visibleCapacity, faceIdx);
+        for (f = 0; f < numOfVisible; ++f)
+        {
+            for (k = 0; k < 3; ++k)
+            {
+                HullFace *const neighbor = &hull->faces[hull->faces[hull->visible[f]].neighbor[k]];
+                if (!neighbor->alive)
+                {
+                    continue;
+                }
+                if (distanceFromFace(neighbor, atoms, eye) > hull->epsilon)
+                {
+                    neighbor->alive = 0;
+                    pushIndex(&hull->visible, &numOfVisible, &hull->visibleCapacity, \
+                              hull->faces[hull->visible[f]].neighbor[k]);
+                }
+                else
+                {
+                    pushIndex(&hull->horizon, &numOfHorizon, &hull->horizonCapacity, \
+                              3 * hull->visible[f] + k);
+                }
+            }
+        }
+        // the cone of new faces over the horizon, each one linked to the hidden face across its
+        // horizon edge:
+        const size_t firstNew = hull->faceCount;
+        for (f = 0; f < numOfHorizon; ++f)
+        {
+            const size_t removed = hull->horizon[f] / 3, edge = hull->horizon[f] % 3;
+            const size_t a = hull->faces[removed].v[edge];
+            const size_t b = hull->faces[removed].v[(edge + 1) % 3];
+            const size_t hidden = hull->faces[removed].neighbor[edge];
+            const size_t cone = addHullFace(hull, atoms, a, b, eye);
+            hull->faces[cone].neighbor[0] = hidden;
+            for (j = 0; j < 3; ++j)
+            {
+                if (hull->faces[hidden].v[j] == b && hull->faces[hidden].v[(j + 1) % 3] == a)
+                {
+                    hull->faces[hidden].neighbor[j] = cone;
+                }
+            }
+            hull->coneOf[a] = cone;
+        }
+        // the new faces around the atom: the one after (a, b, eye) starts at b:
+        for (f = firstNew; f < hull->faceCount; ++f)
+        {
+            const size_t next = hull->coneOf[hull->faces[f].v[1]];
+            hull->faces[f].neighbor[1] = next;
+            hull->faces[next].neighbor[2] = f;
+        }
+        // re-assigns the outside sets of the removed faces:
+        for (f = 0; f < numOfVisible; ++f)
+        {
+            HullFace *const face = &hull->faces[hull->visible[f]];
+            for (k = 0; k < face->outsideCount; ++k)
+            {
+                if (face->outside[k] != eye)
+                {
+                    assignToFace(hull, atoms, face->outside[k], firstNew);
+                }
+            }
+            free(face->outside);
+            face->outside = NULL;
+            face->outsideCount = face->outsideCapacity = 0;
+        }
+    }
+
+/**
+ * computes the vertices of the convex hull of the atoms (with the quickhull algorithm).
+ * @param atoms: the protein atoms.
+ * @param vertices: array of size <atoms->count>, receives the indices of the hull's vertices.
+ * @return the number of hull vertices, or 0 if the atoms are degenerate (i.e: less than
+ *         MIN_ATOMS_FOR_HULL atoms, or all of them lie on a plane).
+ */
+size_t calculateHullVertices(const AtomStore *const atoms, \
+                             size_t vertices[])
+    {
+        if (atoms->count < MIN_ATOMS_FOR_HULL)
+        {
+            return 0;
+        }
+        Hull hull;
+        hull.faceCount = 0;
+        hull.faceCapacity = HULL_INITIAL_CAPACITY;
+        hull.faces = (HullFace *)malloc(hull.faceCapacity * sizeof(HullFace));
+        if (hull.faces == NULL)
+        {
+            printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+        }
+        // the tolerance of the plane computations, relative to the atoms magnitude:
+        double maxAbs[DIMENSIONS] = {0};
+        size_t i, d, f, numOfVertices = 0;
+        for (i = 0; i < atoms->count; ++i)
+        {
+            for (d = 0; d < DIMENSIONS; ++d)
+            {
+                maxAbs[d] = fmax(maxAbs[d], fabs(atoms->coord[d][i]));
+            }
+        }
+        hull.epsilon = 3 * DBL_EPSILON * (maxAbs[0] + maxAbs[1] + maxAbs[2]);
+
+        size_t simplex[MIN_ATOMS_FOR_HULL];
+        if (buildInitialSimplex(&hull, atoms, simplex))
+        {
+            for (i = 0; i < atoms->count; ++i)
+            {
+                if (i != simplex[0] && i != simplex[1] && i != simplex[2] && i != simplex[3])
+                {
+                    assignToFace(&hull, atoms, i, 0);
+                }
+            }
+            hull.visibleCapacity = hull.horizonCapacity = HULL_INITIAL_CAPACITY;
+            hull.visible = (size_t *)malloc(hull.visibleCapacity * sizeof(size_t));
+            hull.horizon = (size_t *)malloc(hull.horizonCapacity * sizeof(size_t));
+            hull.coneOf = (size_t *)malloc(atoms->count * sizeof(size_t));
+            if (hull.visible == NULL || hull.horizon == NULL || hull.coneOf == NULL)
+            {
+                printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+            }
+            // new faces are appended, and only they receive atoms, so one sweep is enough:
+            for (f = 0; f < hull.faceCount; ++f)
+            {
+                if (hull.faces[f].alive && hull.faces[f].outsideCount > 0)
+                {
+                    expandHull(&hull, atoms, f);
+                }
+            }
+            free(hull.visible);
+            free(hull.horizon);
+            free(hull.coneOf);
+            // collects the vertices of the alive faces (each one once):
+            char *isVertex = (char *)calloc(atoms->count, sizeof(char));
+            if (isVertex == NULL)
+            {
+                printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+            }
+            for (f = 0; f < hull.faceCount; ++f)
+            {
+                for (d = 0; hull.faces[f].alive && d < 3; ++d)
+                {
+                    const size_t v = hull.faces[f].v[d];
+                    if (!isVertex[v])
+                    {
+                        vertices[numOfVertices++] = v;
+                        isVertex[v] = 1;
+                    }
+                }
+            }
+            free(isVertex);
+        }
+        for (f = 0; f < hull.faceCount; ++f)
+        {
+            free(hull.faces[f].outside);
+        }
+        free(hull.faces);
+        return numOfVertices;
+    }
+
+/**
+ * orders PlanarPoints by x, and then by y (for qsort).
+ */
+int comparePlanarPoints(const void *a, const void *b)
+    {
+        const PlanarPoint *const p = (const PlanarPoint *)a, *const q = (const PlanarPoint *)b;
+        if (p->x != q->x)
+        {
+            return (p->x > q->x) - (p->x < q->x);
+        }
+        return (p->y > q->y) - (p->y < q->y);
+    }
+
+/**
+ * @return the z of the cross product of (a - o) and (b - o): positive if o, a, b turn left.
+ */
+double planarCross(const PlanarPoint *const o, const PlanarPoint *const a, \
+                   const PlanarPoint *const b)
+    {
+        return (a->x - o->x) * (b->y - o->y) - (a->y - o->y) * (b->x - o->x);
+    }
+
+/**
+ * computes the vertices of the 2D convex hull of degenerate atoms (that lie on a plane, or on a
+ * line, see calculateHullVertices) in their plane, with the monotone chain algorithm. the plane
+ * is spanned by the atom farthest from the first atom, and by the atom farthest from the line
+ * between them (collinear atoms get a y of 0), and the farthest pair of the atoms is a pair of
+ * these vertices.
+ * @param atoms: the protein atoms (at least 1).
+ * @param vertices: array of size <atoms->count>, receives the indices of the hull's vertices.
+ * @return the number of hull vertices.
+ */
+size_t calculatePlanarHullVertices(const AtomStore *const atoms, size_t vertices[])
+    {
+        const size_t n = atoms->count;
+        size_t i, d, far = 0, numOfVertices = 0;
+        double u[DIMENSIONS], v[DIMENSIONS] = {0}, w[DIMENSIONS], norm = 0, cross = 0;
+        for (i = 1; i < n; ++i)
+        {
+            if (squaredDistance(atoms, 0, i) > squaredDistance(atoms, 0, far))
+            {
+                far = i;
+            }
+        }
+        for (d = 0; d < DIMENSIONS; ++d)
+        {
+            u[d] = (double)atoms->coord[d][far] - atoms->coord[d][0];
+            norm += u[d] * u[d];
+        }
+        for (d = 0; d < DIMENSIONS && norm > 0; ++d)
+        {
+            u[d] /= sqrt(norm);
+        }
+        // v: the direction of the atom farthest from the line, perpendicular to u:
+        for (i = 0; i < n; ++i)
+        {
+            double dot = 0, length = 0;
+            for (d = 0; d < DIMENSIONS; ++d)
+            {
+                w[d] = (double)atoms->coord[d][i] - atoms->coord[d][0];
+                dot += w[d] * u[d];
+            }
+            for (d = 0; d < DIMENSIONS; ++d)
+            {
+                w[d] -= dot * u[d];
+                length += w[d] * w[d];
+            }
+            if (length > cross)
+            {
+                cross = length;
+                for (d = 0; d < DIMENSIONS; ++d)
+                {
+                    v[d] = w[d] / sqrt(length);
+                }
+            }
+        }
+        PlanarPoint *points = (PlanarPoint *)malloc(n * sizeof(PlanarPoint));
+        PlanarPoint *chain = (PlanarPoint *)malloc(2 * n * sizeof(PlanarPoint));
+        if (points == NULL || chain == NULL)
+        {
+            printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+        }
+        for (i = 0; i < n; ++i)
+        {
+            points[i].x = points[i].y = 0;
+            points[i].index = i;
+            for (d = 0; d < DIMENSIONS; ++d)
+            {
+                const double offset = (double)atoms->coord[d][i] - atoms->coord[d][0];
+                points[i].x += offset * u[d];
+                points[i].y += offset * v[d];
+            }
+        }
+        qsort(points, n, sizeof(PlanarPoint), comparePlanarPoints);
+        // the lower chain from left to right, and then the upper one back (without repeating
+        // their ends):
+        size_t k = 0;
+        for (i = 0; i < n; ++i)
+        {
+            while (k >= 2 && planarCross(&chain[k - 2], &chain[k - 1], &points[i]) <= 0)
+            {
+                --k;
+            }
+            chain[k++] = points[i];
+        }
+        const size_t lower = k + 1;
+        for (i = n - 1; i > 0; --i)
+        {
+            while (k >= lower && planarCross(&chain[k - 2], &chain[k - 1], &points[i - 1]) <= 0)
+            {
+                --k;
+            }
+            chain[k++] = points[i - 1];
+        }
+        k -= (n > 1); // the last one is the first one
+        for (i = 0; i < k; ++i)
+        {
+            vertices[numOfVertices++] = chain[i].index;
+        }
+        free(points);
+        free(chain);
+        return numOfVertices;
+    }
+
+    /**
+     * calculate and returns the DMax value of the protein described as atoms[], by reducing the
+     * atoms to the vertices of their convex hull (the farthest pair of atoms is always a pair of
+     * hull vertices), and comparing every pair of those vertices (with the brute force engine,
+     * once they are more than MAX_HULL_VERTICES_FOR_LOOP).
+     * degenerate atoms sets (that have no 3D hull) fall back to the brute force engine.
+     * @param atoms : the protein atoms.
+     * @param numOfThreads : the maximal num of threads for the brute force fallback.
+     * @return DMax value of the protein described as atoms[].
+     */
+double calculateDMaxHull(const AtomStore *const atoms, const size_t numOfThreads)
+    {
+        size_t *vertices = (size_t *)malloc(atoms->count * sizeof(size_t));
+        if (vertices == NULL)
+        {
+            printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+        }
+        const size_t numOfVertices = calculateHullVertices(atoms, vertices);
+        if (numOfVertices == 0)
+        {
+            free(vertices);
+            return calculateDMaxBruteForce(atoms, numOfThreads);
+        }
+        size_t i, j;
+        double max = 0;
+        if (numOfVertices > MAX_HULL_VERTICES_FOR_LOOP)
+        {
+            AtomStore hullAtoms;
+            initAtomStore(&hullAtoms);
+            reserveAtomStore(&hullAtoms, numOfVertices);
+            for (i = 0; i < numOfVertices; ++i)
+            {
+                addAtom(&hullAtoms, atoms->coord[0][vertices[i]], atoms->coord[1][vertices[i]], \
+                        atoms->coord[2][vertices[i]]);
+            }
+            free(vertices);
+            max = calculateDMaxBruteForce(&hullAtoms, numOfThreads);
+            freeAtomStore(&hullAtoms);
+            return max;
+        }
+        for (i = 0; i < numOfVertices; ++i)
+        {
+            for (j = i + 1; j < numOfVertices; ++j)
+            {
+                max = fmax(max, squaredDistance(atoms, vertices[i], vertices[j]));
+            }
+        }
+        free(vertices);
+        return sqrt(max);
+    }
+
+    /**
+     * calculate and returns the DMax value of the protein described as atoms[].
+     * @param atoms : the protein atoms.
+     * @param mode : the engine to compute DMax with (see DMaxMode). DMAX_CHECK computes it
+     *               with the hull engine (see printDMax for the check itself).
+     * @param numOfThreads : the maximal num of threads for brute force searches.
+     * @return DMax value of the protein described as atoms[].
+     */
+double calculateDMax(const AtomStore *const atoms, const DMaxMode mode, \
+                     const size_t numOfThreads)
+    {
+        return (mode == DMAX_BRUTE) ? calculateDMaxBruteForce(atoms, numOfThreads) : \
+                                      calculateDMaxHull(atoms, numOfThreads);
+    }
+
+
+//----------------------SPATIAL GRID---------------------------------------------------------------
+/**
+ * @param grid: the grid.
+ * @param atoms: the atoms the grid was built over.
+ * @param atom: index of an atom.
+ * @param dim: the dimension.
+ * @return the coordinate of the cell of the atom in index <atom>, along dimension <dim>.
+ */
+size_t cellCoordinate(const AtomGrid *const grid, const AtomStore *const atoms, \
+                      const size_t atom, const size_t dim)
+    {
+        const size_t cell = (size_t)((atoms->coord[dim][atom] - grid->min[dim]) / grid->cellSize);
+        return (cell < grid->dims[dim]) ? cell : grid->dims[dim] - 1;
+    }
+
+/**
+ * @param grid: the grid.
+ * @param atoms: the atoms the grid was built over.
+ * @param atom: index of an atom.
+ * @return the index of the cell of the atom in index <atom>.
+ */
+size_t cellOf(const AtomGrid *const grid, const AtomStore *const atoms, const size_t atom)
+    {
+        return (cellCoordinate(grid, atoms, atom, 2) * grid->dims[1] + \
+                cellCoordinate(grid, atoms, atom, 1)) * grid->dims[0] + \
+               cellCoordinate(grid, atoms, atom, 0);
+    }
+
+/**
+ * builds a grid of cells of (at least) <cellSize> over the non empty <atoms>, in time linear
+ * in the num of atoms (the atoms are counting sorted by their cell).
+ * the cells grow when the atoms are too sparse for a grid of <cellSize> cells (see
+ * MAX_GRID_CELLS_PER_ATOM).
+ * @param grid: the grid (must be freed with freeAtomGrid).
+ * @param atoms: the atoms.
+ * @param cellSize: the minimal edge of the cells.
+ */
+void buildAtomGrid(AtomGrid *const grid, const AtomStore *const atoms, const double cellSize)
+    {
+        double extent[DIMENSIONS];
+        size_t d, i;
+        for (d = 0; d < DIMENSIONS; ++d)
+        {
+            float low = atoms->coord[d][0], high = atoms->coord[d][0];
+            for (i = 1; i < atoms->count; ++i)
+            {
+                low = fminf(low, atoms->coord[d][i]);
+                high = fmaxf(high, atoms->coord[d][i]);
+            }
+            grid->min[d] = low;
+            extent[d] = (double)high - low;
+        }
+        // the cells grow until there are no more than MAX_GRID_CELLS_PER_ATOM cells per atom:
+        const double maxCells = (double)MAX_GRID_CELLS_PER_ATOM * atoms->count;
+        grid->cellSize = cellSize;
+        while (1)
+        {
+            double numOfCells = 1;
+            for (d = 0; d < DIMENSIONS; ++d)
+            {
+                numOfCells *= floor(extent[d] / grid->cellSize) + 1;
+            }
+            if (numOfCells <= maxCells)
+            {
+                break;
+            }
+            grid->cellSize *= 2;
+        }
+        for (d = 0; d < DIMENSIONS; ++d)
+        {
+            grid->dims[d] = (size_t)(extent[d] / grid->cellSize) + 1;
+        }
+        const size_t cells = grid->dims[0] * grid->dims[1] * grid->dims[2];
+        grid->cellStart = (size_t *)calloc(cells + 1, sizeof(size_t));
+        size_t *cellOfAtom = (size_t *)malloc(atoms->count * sizeof(size_t));
+        if (grid->cellStart == NULL || cellOfAtom == NULL)
+        {
+            printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+        }
+        for (i = 0; i < atoms->count; ++i)
+        {
+            cellOfAtom[i] = cellOf(grid, atoms, i);
+            ++grid->cellStart[cellOfAtom[i] + 1];
+        }
+        for (i = 0; i < cells; ++i)
+        {
+            grid->cellStart[i + 1] += grid->cellStart[i];
+        }
+        initAtomStore(&grid->atoms);
+        reserveAtomStore(&grid->atoms, atoms->count);
+        grid->atoms.count = atoms->count;
+        for (i = 0; i < atoms->count; ++i) // cellStart[c] is the next free slot of cell c
+        {
+            const size_t slot = grid->cellStart[cellOfAtom[i]]++;
+            for (d = 0; d < DIMENSIONS; ++d)
+            {
+                grid->atoms.coord[d][slot] = atoms->coord[d][i];
+            }
+        }
+        for (i = cells; i > 0; --i) // the placement moved every start to the next cell's start
+        {
+            grid->cellStart[i] = grid->cellStart[i - 1];
+        }
+        grid->cellStart[0] = 0;
+        free(cellOfAtom);
+    }
+
+/**
+ * frees the memory of <grid>.
+ * @param grid: the grid.
+ */
+void freeAtomGrid(AtomGrid *const grid)
+    {
+        freeAtomStore(&grid->atoms);
+        free(grid->cellStart);
+        grid->cellStart = NULL;
+    }
+
+/**
+ * counts the contacts between the atoms of two grid cells.
+ * @param grid: the grid.
+ * @param a, b: indices of cells (the pairs within cell <a> are counted when a == b).
+ * @param squaredCutoff: the squared distance within which atoms are in contact.
+ * @param neighbors: neighbors[i] is the num of contacts of the atom in index i (of grid->atoms),
+ *                   incremented for every contact found.
+ * @param contacts: the contacts, receives the contacts found.
+ */
+void countCellContacts(const AtomGrid *const grid, const size_t a, const size_t b, \
+                       const double squaredCutoff, size_t neighbors[], \
+                       ContactStats *const contacts)
+    {
+        size_t i, j;
+        for (i = grid->cellStart[a]; i < grid->cellStart[a + 1]; ++i)
+        {
+            for (j = (a == b) ? i + 1 : grid->cellStart[b]; j < grid->cellStart[b + 1]; ++j)
+            {
+                const double distance = squaredDistance(&grid->atoms, i, j);
+                if (distance <= squaredCutoff)
+                {
+                    ++contacts->numOfContacts;
+                    contacts->sumOfDistances += sqrt(distance);
+                    ++neighbors[i];
+                    ++neighbors[j];
+                }
+            }
+        }
+    }
+
+/**
+ * calculates the contacts of the non empty <atoms>: the pairs of atoms within <cutoff> of each
+ * other. the atoms are put in a grid of cells of (at least) <cutoff>, so only the atoms of
+ * neighboring cells are compared: every cell is compared with itself and with the 13 neighbors
+ * that follow it (the other 13 compare themselves with it), which takes near linear time for
+ * atoms that are spread like a protein's.
+ * @param atoms: the protein atoms.
+ * @param cutoff: the distance within which atoms are in contact (positive).
+ * @param contacts: receives the contacts.
+ */
+void calculateContacts(const AtomStore *const atoms, const double cutoff, \
+                       ContactStats *const contacts)
+    {
+        AtomGrid grid;
+        buildAtomGrid(&grid, atoms, cutoff);
+        size_t *neighbors = (size_t *)calloc(atoms->count, sizeof(size_t));
+        if (neighbors == NULL)
+        {
+            printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+        }
+        memset(contacts, 0, sizeof(ContactStats));
+        const double squaredCutoff = cutoff * cutoff;
+        size_t x, y, z, i;
+        int dx, dy, dz;
+        for (z = 0; z < grid.dims[2]; ++z)
+        {
+            for (y = 0; y < grid.dims[1]; ++y)
+            {
+                for (x = 0; x < grid.dims[0]; ++x)
+                {
+                    const size_t cell = (z * grid.dims[1] + y) * grid.dims[0] + x;
+                    for (dz = 0; dz <= 1; ++dz)
+                    {
+                        for (dy = -1; dy <= 1; ++dy)
+                        {
+                            for (dx = -1; dx <= 1; ++dx)
+                            {
+                                // the neighbors that follow the cell (and the cell itself):
+                                if ((dy * 3 + dx) + dz * 9 < 0 || (x == 0 && dx < 0) || \
+                                    (y == 0 && dy < 0) || x + dx >= grid.dims[0] || \
+                                    y + dy >= grid.dims[1] || z + dz >= grid.dims[2])
+                                {
+                                    continue;
+                                }
+                                const size_t other = ((z + dz) * grid.dims[1] + (y + dy)) * \
+                                                     grid.dims[0] + (x + dx);
+                                countCellContacts(&grid, cell, other, squaredCutoff, \
+                                                  neighbors, contacts);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        for (i = 0; i < atoms->count; ++i)
+        {
+            contacts->numOfAtomsInContact += (neighbors[i] > 0);
+            if (neighbors[i] > contacts->maxNeighbors)
+            {
+                contacts->maxNeighbors = neighbors[i];
+            }
+        }
+        free(neighbors);
+        freeAtomGrid(&grid);
+    }
+
+
+//-----------------------------------PRINTING--------------------------------------------------
+/**
+ * prints an informative error msg to <stream>.
+ * @param stream: the stream to print to.
+ * @param errorNum: number from 0 to 4 that correspond to the errors described as macros
+ *                  (see documentation).
+ * @param fileName: the file name (NULL if doesn't exist).
+ * @param len: the length of the problematic in the file (0 if doesn't exist).
+ */
+void printError(FILE *const stream, const int errorNum, const char *const fileName, \
+                const size_t len)
+    {
+        switch(errorNum)
+        {
+            //clarify the correct usage:
+            case(0):
+                USAGE_ERR(stream);
+                break;
+
+            //notify that an error occurred in opening the file that is passed as a param:
+            case(1):
+                OPEN_FILE_ERR(stream, fileName);
+                break;
+
+            //notify that a pdb file with no atoms was submitted:
+            case(2):
+                NO_ATOMS_ERR(stream, fileName);
+                break;
+
+            //notify when a valid atom line is shorter then the minimal value declared
+            case(3):
+                LINE_LENGTH_ERR(stream, len);
+                break;
+
+            //notify that a memory allocation failed:
+            case(4):
+                MEM_ALLOC_ERR(stream);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+/**
+ * prints an informative error msg to the stderr and exits neatly (i.e: closes open file is
+ * exists) with failure code.
+ * @param errorNum: number from 0 to 4 that correspond to the errors described as macros
+ *                  (see documentation).
+ * @param file: pointer to the file (NULL if doesn't exist).
+ * @param fileName: the file name (NULL if doesn't exist).
+ * @param len: the length of the problematic in the file (NULL if doesn't exist).
+ */
+void printErrorAndExit(int errorNum, FILE *const file, const char * const fileName, \
+                       const size_t len)
+    {
+        printError(stderr, errorNum, fileName, len);
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+    exit(EXIT_FAILURE);
+    }
+
+/**
+ * prints the center of gravity value of the protein.
+ * @param out: the stream to print to.
+ * @param stats: the statistics of the protein atoms.
+ * @param centerOfGravity: Array of size <DIMENSIONS>.
+ */
+void printCenterOfGravity(FILE *const out, const AtomStats *const stats, float centerOfGravity[])
+    {
+        centerOfGravityOfStats(stats, centerOfGravity);
+        fprintf(out, "Cg = %.3f %.3f %.3f\n" , centerOfGravity[0], centerOfGravity[1], \
+                centerOfGravity[2]);
+    }
+
+/**
+ * prints the ionic radius value of the protein
+ * @param out: the stream to print to.
+ * @param stats: the statistics of the protein atoms.
+ */
+void printIonicRadius(FILE *const out, const AtomStats *const stats)
+    {
+        double ionicRadius = ionicRadiusOfStats(stats);
+        fprintf(out, "Rg = %.3f\n", ionicRadius);
+    }
+/**
+ * prints the Dmax value of the protein. in DMAX_CHECK mode, also computes the brute force Dmax
+ * and prints a warning to <err> if the two disagree.
+ * @param out: the stream to print to.
+ * @param err: the stream to print warnings to.
+ * @param atoms: the protein atoms.
+ * @param mode : the engine to compute Dmax with (see DMaxMode).
+ * @param numOfThreads : the maximal num of threads for brute force searches.
+ * @param fileName: the file name .
+ */
+void printDMax(FILE *const out, FILE *const err, const AtomStore *const atoms, \
+               const DMaxMode mode, const size_t numOfThreads, const char *const fileName)
+    {
+        double dMax = calculateDMax(atoms, mode, numOfThreads);
+        fprintf(out, "Dmax = %.3f\n", dMax);
+        if (mode == DMAX_CHECK)
+        {
+            const double reference = calculateDMaxBruteForce(atoms, numOfThreads);
+            if (fabs(dMax - reference) > DMAX_CHECK_TOLERANCE)
+            {
+                DMAX_MISMATCH_WARN(err, fileName, dMax, reference);
+            }
+        }
+    }
+/**
+ * prints the analyze results of a protein whose statistics were computed.
+ * @param out: the stream to print to.
+ * @param err: the stream to print warnings to.
+ * @param fileName: the file name .
+ * @param stats: the statistics of the protein atoms.
+ * @param dMaxAtoms: atoms whose Dmax is the protein's Dmax (all of them, or a hull summary).
+ * @param mode : the engine to compute Dmax with (see DMaxMode).
+ * @param numOfThreads : the maximal num of threads for brute force searches.
+ */
+void printAnalyzeResults(FILE *const out, FILE *const err, const char *const fileName, \
+                         const AtomStats *const stats, const AtomStore *const dMaxAtoms, \
+                         const DMaxMode mode, const size_t numOfThreads)
+    {
+        fprintf(out, "PDB file %s, %zd atoms were read\n", fileName, stats->count);
+        float centerOfGravity[DIMENSIONS] = {0};
+        printCenterOfGravity(out, stats, centerOfGravity);
+        printIonicRadius(out, stats);
+        printDMax(out, err, dMaxAtoms, mode, numOfThreads, fileName);
+    }
+
+/**
+ * prints the contacts of the protein (see calculateContacts).
+ * @param out: the stream to print to.
+ * @param atoms: the protein atoms (non empty).
+ * @param cutoff: the distance within which atoms are in contact (positive).
+ */
+void printContacts(FILE *const out, const AtomStore *const atoms, const double cutoff)
+    {
+        ContactStats contacts;
+        calculateContacts(atoms, cutoff, &contacts);
+        fprintf(out, "Contacts = %zd within %.3f\n", contacts.numOfContacts, cutoff);
+        fprintf(out, "Atoms in contact = %zd\n", contacts.numOfAtomsInContact);
+        fprintf(out, "Neighbors per atom = %.3f, max %zd\n", \
+                2.0 * contacts.numOfContacts / atoms->count, contacts.maxNeighbors);
+        fprintf(out, "Mean contact distance = %.3f\n", (contacts.numOfContacts > 0) ? \
+                contacts.sumOfDistances / contacts.numOfContacts : 0);
+    }
+
+/**
+ * prints the protein's analyze results
+ * @param out: the stream to print to.
+ * @param err: the stream to print warnings to.
+ * @param fileName: the file name .
+ * @param atoms: the protein atoms.
+ * @param options : the program's options.
+ */
+void printProteinAnalyze(FILE *const out, FILE *const err, const char *const fileName, \
+                         const AtomStore *const atoms, const Options *const options)
+    {
+        AtomStats stats;
+        calculateAtomStats(atoms, &stats); // a single pass for both Cg and Rg
+        printAnalyzeResults(out, err, fileName, &stats, atoms, options->dMaxMode, \
+                            options->numOfDMaxThreads);
+    }
+
+
+//----------------------READING--------------------------------------------------------------------
+
+/**
+ * parses the coordinate held in the COORDINATE_SIZE chars starting at <field> (the fixed width
+ * %8.3f columns of an atom line), without copying them.
+ * plain decimals ([spaces][sign]digits[.digits][spaces]) are converted directly: the digits
+ * make an exact float mantissa that is divided once by a power of 10, which gives the same
+ * (correctly rounded) value as strtof. any other field (e.g: exponents) falls back to strtof.
+ * @param field: address of the first char of the coordinate's field.
+ * @return the coordinate the field holds.
+ */
+float parseCoordinate(const char *const field)
+    {
+        static const float powersOfTen[COORDINATE_SIZE + 1] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, \
+                                                               1e5f, 1e6f, 1e7f, 1e8f};
+        size_t i = 0, fractionDigits = 0;
+        int negative = 0, seenPoint = 0;
+        long mantissa = 0;
+        while (i < COORDINATE_SIZE && field[i] == ' ')
+        {
+            ++i;
+        }
+        if (i < COORDINATE_SIZE && (field[i] == '-' || field[i] == '+'))
+        {
+            negative = (field[i] == '-');
+            ++i;
+        }
+        for (; i < COORDINATE_SIZE; ++i)
+        {
+            if (field[i] >= '0' && field[i] <= '9')
+            {
+                mantissa = mantissa * 10 + (field[i] - '0');
+                fractionDigits += seenPoint;
+            }
+            else if (field[i] == '.' && !seenPoint)
+            {
+                seenPoint = 1;
+            }
+            else
+            {
+                break;
+            }
+        }
+        while (i < COORDINATE_SIZE && field[i] == ' ')
+        {
+            ++i;
+        }
+        if (i < COORDINATE_SIZE || mantissa >= MAX_EXACT_MANTISSA) // not a plain decimal
+        {
+            char asChar[COORDINATE_SIZE + 1] = {'\0'};
+            memcpy(asChar, field, COORDINATE_SIZE);
+            return strtof(asChar, NULL);
+        }
+        const float value = (float)mantissa / powersOfTen[fractionDigits];
+        return negative ? -value : value;
+    }
+
+/**
+ * create a new atom from the data in <buff>, and ads it to the end of <atoms>.
+ * we assume that the data in <buff> is valid (i.e: holds the coordinates' columns)
+ * @param atoms: the store to which we add the new atom.
+ * @param buff : holds the atom's data.
+ */
+void createAtom(AtomStore *const atoms, const char *const buff)
+    {
+        addAtom(atoms, parseCoordinate(&buff[X_START]), parseCoordinate(&buff[Y_START]), \
+                parseCoordinate(&buff[Z_START]));
+    }
+
+/**
+ * adds the atom of the line to <atoms>, if it is an atom line (i.e: starts with ATOM_PREFIX).
+ * @param line: the line (not necessarily null terminated).
+ * @param len: the line's length, including its '\n' (if any).
+ * @param atoms: the store to which we add the new atom.
+ * @param lineLen: receives <len> if the line is an ATOM line that is too short.
+ * @return: 0 on success, or 3 (see LINE_LENGTH_ERR) if the line is an ATOM line that is too short.
+ */
+int readAtomLine(const char *const line, const size_t len, AtomStore *const atoms, \
+                 size_t *const lineLen)
+    {
+        if (len >= PREFIX_SIZE && !memcmp(line + PREFIX_START, ATOM_PREFIX, PREFIX_SIZE))
+        {
+            if (len <= MIN_CHARS_IN_ATOM_LINE) // err 3: ATOM line shorter then 61
+            {
+                *lineLen = len;
+                return 3;
+            }
+            createAtom(atoms, line);
+        }
+        return 0;
+    }
+
+/**
+ * reserves <atoms> for the largest number of atom lines a file of <fileSize> bytes can hold,
+ * so that loading the whole file needs a single allocation.
+ * @param atoms: the store.
+ * @param fileSize: the size of the file (in bytes).
+ */
+void reserveForFileSize(AtomStore *const atoms, const size_t fileSize)
+    {
+        reserveAtomStore(atoms, fileSize / (MIN_CHARS_IN_ATOM_LINE + 1));
+    }
+
+/**
+ * reads a PDB file, and stores the atoms that were read from it in <atoms> (which is emptied
+ * first). reading stops at the first ATOM line that is too short.
+ * when the file's size is known, <atoms> is reserved up front for the largest number of atom
+ * lines the file can hold, so the whole load needs a single allocation.
+ * @param file: a valid pointer to the file.
+ * @param atoms: the store that receives the atoms.
+ * @param lineLen: receives the length of the ATOM line that is too short (if any).
+ * @return: 0 on success, or 3 (see LINE_LENGTH_ERR) if an ATOM line is too short.
+ */
+int readPDBFile(FILE *const file, AtomStore *const atoms, size_t *const lineLen)
     {
         char buff[MAX_CHARS_IN_ATOM_LINE + 1], prefix[PREFIX_SIZE + 1] = {'\0'};
+        struct stat fileStat;
+        atoms->count = 0;
+        if (fstat(fileno(file), &fileStat) == 0 && S_ISREG(fileStat.st_mode))
+        {
+            reserveForFileSize(atoms, (size_t)fileStat.st_size);
+        }
         char *res = fgets(buff, MAX_CHARS_IN_ATOM_LINE + 1, file);
-        size_t atomCount = 0;
-        while (res != NULL && atomCount < MAX_NUM_OF_ATOMS) // existing line & room to add more atoms
+        while (res != NULL) // existing line
+        {
+            memcpy(prefix, &buff[PREFIX_START], PREFIX_SIZE);
+
+            if (!strcmp(prefix, ATOM_PREFIX)) //line starts with "ATOM  "
+            {
+                if(strlen(res) <= MIN_CHARS_IN_ATOM_LINE) // err 3: ATOM line shorter then 61
+                {
+                    *lineLen = strlen(res);
+                    return 3;
+                }
+                createAtom(atoms, buff);
+            }
+            res = fgets(buff, MAX_CHARS_IN_ATOM_LINE + 1, file);
+        }
+        return 0;
+    }
+
+/**
+ * reads the atom lines of a PDB file that is mapped to memory into <atoms> (which is emptied
+ * first). reading stops at the first ATOM line that is too short. the lines are scanned in
+ * place: the coordinates are parsed straight from the mapped bytes.
+ * @param content: the mapped content of the file.
+ * @param size: the size of the file.
+ * @param atoms: the store that receives the atoms.
+ * @param lineLen: receives the length of the ATOM line that is too short (if any).
+ * @return: 0 on success, or 3 (see LINE_LENGTH_ERR) if an ATOM line is too short.
+ */
+int readMappedLines(const char *const content, const size_t size, AtomStore *const atoms, \
+                    size_t *const lineLen)
+    {
+        atoms->count = 0;
+        reserveForFileSize(atoms, size);
+        const char *line = content;
+        const char *const end = content + size;
+        while (line < end) // existing line
+        {
+            const char *newLine = (const char *)memchr(line, '\n', (size_t)(end - line));
+            // the line's length, including its '\n' (as counted by readPDBFile):
+            const size_t len = (newLine != NULL) ? (size_t)(newLine - line) + 1 : \
+                               (size_t)(end - line);
+            if (readAtomLine(line, len, atoms, lineLen)) // err 3: ATOM line too short
+            {
+                return 3;
+            }
+            line += len;
+        }
+        return 0;
+    }
+
+/**
+ * reads a PDB file through a read-only memory map of it, and stores the atoms that were read
+ * from it in <atoms> (which is emptied first). reading stops at the first ATOM line that is too
+ * short. the lines are scanned in place: the coordinates are parsed straight from the mapped
+ * bytes. files that can't be mapped (e.g: pipes, or empty files) are read by readPDBFile instead.
+ * @param file: a valid pointer to the file.
+ * @param atoms: the store that receives the atoms.
+ * @param lineLen: receives the length of the ATOM line that is too short (if any).
+ * @return: 0 on success, or 3 (see LINE_LENGTH_ERR) if an ATOM line is too short.
+ */
+int readPDBFileMapped(FILE *const file, AtomStore *const atoms, size_t *const lineLen)
+    {
+        struct stat fileStat;
+        if (fstat(fileno(file), &fileStat) != 0 || !S_ISREG(fileStat.st_mode) || \
+            fileStat.st_size == 0)
+        {
+            return readPDBFile(file, atoms, lineLen);
+        }
+        const size_t fileSize = (size_t)fileStat.st_size;
+        void *const map = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+        if (map == MAP_FAILED)
+        {
+            return readPDBFile(file, atoms, lineLen);
+        }
+        posix_madvise(map, fileSize, POSIX_MADV_SEQUENTIAL);
+        const int errorNum = readMappedLines((const char *)map, fileSize, atoms, lineLen);
+        munmap(map, fileSize);
+        return errorNum;
+    }
+
+//----------------------CACHE----------------------------------------------------------------------
+/**
+ * hashes the content of a file (FNV-1a, taken over 8 bytes at a time).
+ * @param content: the content.
+ * @param size: the size of the content.
+ * @return the hash of the content.
+ */
+uint64_t hashFileContent(const char *const content, const size_t size)
+    {
+        uint64_t hash = HASH_OFFSET_BASIS ^ size;
+        size_t i;
+        for (i = 0; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+        {
+            uint64_t word;
+            memcpy(&word, content + i, sizeof(uint64_t));
+            hash = (hash ^ word) * HASH_PRIME;
+        }
+        for (; i < size; ++i)
+        {
+            hash = (hash ^ (unsigned char)content[i]) * HASH_PRIME;
+        }
+        return hash;
+    }
+
+/**
+ * fills the header of the sidecar cache of a PDB file.
+ * @param header: the header.
+ * @param sourceStat: the status of the PDB file.
+ * @param sourceHash: the content hash of the PDB file.
+ * @param count: the num of atoms in the PDB file.
+ */
+void initCacheHeader(CacheHeader *const header, const struct stat *const sourceStat, \
+                     const uint64_t sourceHash, const size_t count)
+    {
+        memset(header, 0, sizeof(CacheHeader));
+        memcpy(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        header->version = CACHE_VERSION;
+        header->byteOrder = CACHE_BYTE_ORDER;
+        header->sourceSize = (uint64_t)sourceStat->st_size;
+        header->sourceMTimeSec = (int64_t)sourceStat->st_mtim.tv_sec;
+        header->sourceMTimeNSec = (int64_t)sourceStat->st_mtim.tv_nsec;
+        header->sourceHash = sourceHash;
+        header->count = count;
+    }
+
+/**
+ * reads the atoms from the sidecar cache <cacheName> (through a memory map of it) into <atoms>,
+ * if the cache is valid for the PDB file described by <expected>.
+ * @param cacheName: the name of the sidecar cache.
+ * @param expected: the header of a valid cache, except for its count.
+ * @param atoms: the store that receives the atoms.
+ * @return 1 if the atoms were read, 0 if the cache is missing, corrupted or out of date.
+ */
+int loadCache(const char *const cacheName, const CacheHeader *const expected, \
+              AtomStore *const atoms)
+    {
+        FILE *cache = fopen(cacheName, "rb");
+        if (cache == NULL)
+        {
+            return 0;
+        }
+        struct stat cacheStat;
+        void *map = MAP_FAILED;
+        if (fstat(fileno(cache), &cacheStat) == 0 && S_ISREG(cacheStat.st_mode) && \
+            (size_t)cacheStat.st_size >= sizeof(CacheHeader))
+        {
+            map = mmap(NULL, (size_t)cacheStat.st_size, PROT_READ, MAP_PRIVATE, fileno(cache), 0);
+        }
+        fclose(cache);
+        if (map == MAP_FAILED)
+        {
+            return 0;
+        }
+        const size_t cacheSize = (size_t)cacheStat.st_size;
+        CacheHeader header;
+        memcpy(&header, map, sizeof(CacheHeader));
+        const size_t count = (size_t)header.count;
+        const size_t atomSize = DIMENSIONS * sizeof(float);
+        const size_t payloadSize = cacheSize - sizeof(CacheHeader);
+        header.count = expected->count; // the only field that is not known in advance
+        const int valid = memcmp(&header, expected, sizeof(CacheHeader)) == 0 && \
+                          payloadSize % atomSize == 0 && payloadSize / atomSize == count;
+        if (valid)
+        {
+            const float *const coord = (const float *)((const char *)map + sizeof(CacheHeader));
+            size_t d;
+            atoms->count = 0;
+            reserveAtomStore(atoms, count);
+            for (d = 0; d < DIMENSIONS && count > 0; ++d)
+            {
+                memcpy(atoms->coord[d], coord + d * count, count * sizeof(float));
+            }
+            atoms->count = count;
+        }
+        munmap(map, cacheSize);
+        return valid;
+    }
+
+/**
+ * writes the sidecar cache <cacheName> of <atoms>. the cache is written to a temporary file
+ * that replaces the cache once it is complete, so a cache is never read half written.
+ * failing to write the cache is silently ignored (it will be written by a later run).
+ * @param cacheName: the name of the sidecar cache.
+ * @param header: the header of the cache.
+ * @param atoms: the atoms of the PDB file.
+ */
+void writeCache(const char *const cacheName, const CacheHeader *const header, \
+                const AtomStore *const atoms)
+    {
+        char *tempName = (char *)malloc(strlen(cacheName) + sizeof(CACHE_TEMP_SUFFIX));
+        if (tempName == NULL)
+        {
+            printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+        }
+        strcpy(tempName, cacheName);
+        strcat(tempName, CACHE_TEMP_SUFFIX);
+        const int fd = mkstemp(tempName);
+        if (fd < 0)
+        {
+            free(tempName);
+            return;
+        }
+        fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+        FILE *cache = fdopen(fd, "wb");
+        int written = (cache != NULL) && fwrite(header, sizeof(CacheHeader), 1, cache) == 1;
+        size_t d;
+        for (d = 0; d < DIMENSIONS && written && atoms->count > 0; ++d)
+        {
+            written = fwrite(atoms->coord[d], sizeof(float), atoms->count, cache) == atoms->count;
+        }
+        if (cache != NULL)
+        {
+            written = (fclose(cache) == 0) && written;
+        }
+        else
+        {
+            close(fd);
+        }
+        if (!written || rename(tempName, cacheName) != 0)
+        {
+            remove(tempName);
+        }
+        free(tempName);
+    }
+
+/**
+ * reads a PDB file into <atoms> (which is emptied first) from its sidecar cache (see
+ * CacheHeader), or, when the cache is missing or out of date, parses the file through a memory
+ * map of it and writes the cache for the next runs.
+ * files that can't be mapped (e.g: pipes, or empty files) are read by readPDBFile, uncached.
+ * @param file: a valid pointer to the file.
+ * @param fileName: the file name.
+ * @param atoms: the store that receives the atoms.
+ * @param lineLen: receives the length of the ATOM line that is too short (if any).
+ * @return: 0 on success, or 3 (see LINE_LENGTH_ERR) if an ATOM line is too short.
+ */
+int readPDBFileCached(FILE *const file, const char *const fileName, AtomStore *const atoms, \
+                      size_t *const lineLen)
+    {
+        struct stat fileStat;
+        if (fstat(fileno(file), &fileStat) != 0 || !S_ISREG(fileStat.st_mode) || \
+            fileStat.st_size == 0)
+        {
+            return readPDBFile(file, atoms, lineLen);
+        }
+        const size_t fileSize = (size_t)fileStat.st_size;
+        void *const map = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+        if (map == MAP_FAILED)
+        {
+            return readPDBFile(file, atoms, lineLen);
+        }
+        posix_madvise(map, fileSize, POSIX_MADV_SEQUENTIAL);
+        char *cacheName = (char *)malloc(strlen(fileName) + sizeof(CACHE_SUFFIX));
+        if (cacheName == NULL)
+        {
+            printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+        }
+        strcpy(cacheName, fileName);
+        strcat(cacheName, CACHE_SUFFIX);
+        CacheHeader header;
+        initCacheHeader(&header, &fileStat, hashFileContent((const char *)map, fileSize), 0);
+        int errorNum = 0;
+        if (!loadCache(cacheName, &header, atoms))
+        {
+            errorNum = readMappedLines((const char *)map, fileSize, atoms, lineLen);
+            if (!errorNum) // files with a too short ATOM line are not cached
+            {
+                header.count = atoms->count;
+                writeCache(cacheName, &header, atoms);
+            }
+        }
+        munmap(map, fileSize);
+        free(cacheName);
+        return errorNum;
+    }
+
+//----------------------STREAMING------------------------------------------------------------------
+/**
+ * reduces <candidates> to the vertices of the convex hull of its atoms: the only atoms that the
+ * farthest pair of all the atoms streamed so far can be made of.
+ * degenerate atom sets (see calculateHullVertices) are reduced to the vertices of their hull in
+ * their plane instead (see calculatePlanarHullVertices), so <candidates> stays bounded by the
+ * hull's size in either case, rather than by the num of atoms streamed.
+ * @param candidates: the hull vertices of the atoms streamed before, followed by the atoms
+ *                    streamed since.
+ * @param work: a scratch store (its content is replaced).
+ * @param vertices: scratch array of capacity <*verticesCapacity> (realloc-ed if needed).
+ * @param verticesCapacity: the capacity of <*vertices>.
+ */
+void reduceToHull(AtomStore *const candidates, AtomStore *const work, size_t **vertices, \
+                  size_t *const verticesCapacity)
+    {
+        // the atoms move to <work>, and their hull vertices back to <candidates>:
+        const AtomStore atoms = *candidates;
+        *candidates = *work;
+        *work = atoms;
+        if (*verticesCapacity < work->count)
+        {
+            *verticesCapacity = work->capacity;
+            free(*vertices);
+            *vertices = (size_t *)malloc(*verticesCapacity * sizeof(size_t));
+            if (*vertices == NULL)
+            {
+                printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+            }
+        }
+        size_t numOfVertices = calculateHullVertices(work, *vertices);
+        if (numOfVertices == 0 && work->count > 0)
         {
-            memcpy(prefix, &buff[PREFIX_START], PREFIX_SIZE);
+            numOfVertices = calculatePlanarHullVertices(work, *vertices);
+        }
+        size_t i;
+        candidates->count = 0;
+        reserveAtomStore(candidates, numOfVertices);
+        for (i = 0; i < numOfVertices; ++i)
+        {
+            const size_t v = (*vertices)[i];
+            addAtom(candidates, work->coord[0][v], work->coord[1][v], work->coord[2][v]);
+        }
+    }
 
-            if (!strcmp(prefix, ATOM_PREFIX)) //line starts with "ATOM  "
+/**
+ * appends the atoms of <chunk> to the end of <atoms>.
+ * @param atoms: the store.
+ * @param chunk: the atoms to append.
+ */
+void appendAtoms(AtomStore *const atoms, const AtomStore *const chunk)
+    {
+        size_t d;
+        if (atoms->count + chunk->count > atoms->capacity)
+        {
+            reserveAtomStore(atoms, (atoms->count + chunk->count > 2 * atoms->capacity) ? \
+                                    atoms->count + chunk->count : 2 * atoms->capacity);
+        }
+        for (d = 0; d < DIMENSIONS && chunk->count > 0; ++d)
+        {
+            memcpy(atoms->coord[d] + atoms->count, chunk->coord[d], chunk->count * sizeof(float));
+        }
+        atoms->count += chunk->count;
+    }
+
+/**
+ * the body of the reader thread of an AtomStream: reads the file in blocks of
+ * STREAM_BLOCK_SIZE bytes, and parses its atom lines into the stream's chunks, one chunk after
+ * the other, waiting whenever the next chunk was not consumed yet.
+ * @param arg: the AtomStream.
+ * @return NULL.
+ */
+void *streamReader(void *arg)
+    {
+        AtomStream *const stream = (AtomStream *)arg;
+        char *const block = (char *)malloc(STREAM_BLOCK_SIZE);
+        if (block == NULL)
+        {
+            printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+        }
+        size_t filled = 0, chunkIdx = 0;
+        int errorNum = 0, skippingLine = 0, atEnd = 0;
+        AtomStore *chunk = NULL;
+        while (!errorNum && !(atEnd && filled == 0))
+        {
+            if (chunk == NULL) // waits for the next chunk to be consumed:
             {
-                if(strlen(res) <= MIN_CHARS_IN_ATOM_LINE) // err 3: ATOM line shorter then 61
+                pthread_mutex_lock(&stream->lock);
+                while (stream->full[chunkIdx])
                 {
-                    printErrorAndExit(3, file, NULL, strlen(res));
+                    pthread_cond_wait(&stream->changed, &stream->lock);
                 }
-                createAtom(atoms, buff, atomCount);
-                ++atomCount;
+                pthread_mutex_unlock(&stream->lock);
+                chunk = &stream->chunks[chunkIdx];
+                chunk->count = 0;
             }
-            res = fgets(buff, MAX_CHARS_IN_ATOM_LINE + 1, file);
+            if (!atEnd)
+            {
+                const size_t numRead = fread(block + filled, 1, STREAM_BLOCK_SIZE - filled, \
+                                             stream->file);
+                filled += numRead;
+                atEnd = (numRead == 0);
+            }
+            // parses the complete lines of the block (and the last line, at the end of file):
+            const char *line = block;
+            const char *const end = block + filled;
+            while (line < end && chunk->count < STREAM_CHUNK_ATOMS && !errorNum)
+            {
+                const char *newLine = (const char *)memchr(line, '\n', (size_t)(end - line));
+                if (newLine == NULL && !atEnd && (line != block || filled < STREAM_BLOCK_SIZE))
+                {
+                    break; // the rest of the line is in the next block
+                }
+                // a line longer than a block is parsed by its first block, and skipped after:
+                const size_t len = (newLine != NULL) ? (size_t)(newLine - line) + 1 : \
+                                   (size_t)(end - line);
+                if (!skippingLine)
+                {
+                    errorNum = readAtomLine(line, len, chunk, &stream->lineLen);
+                }
+                skippingLine = (newLine == NULL);
+                line += len;
+            }
+            filled = (size_t)(end - line);
+            memmove(block, line, filled);
+            if (chunk->count == STREAM_CHUNK_ATOMS || errorNum || (atEnd && filled == 0))
+            {
+                pthread_mutex_lock(&stream->lock);
+                stream->full[chunkIdx] = 1;
+                pthread_cond_broadcast(&stream->changed);
+                pthread_mutex_unlock(&stream->lock);
+                chunkIdx = (chunkIdx + 1) % STREAM_CHUNKS;
+                chunk = NULL;
+            }
+        }
+        pthread_mutex_lock(&stream->lock);
+        stream->errorNum = errorNum;
+        stream->finished = 1;
+        pthread_cond_broadcast(&stream->changed);
+        pthread_mutex_unlock(&stream->lock);
+        free(block);
+        return NULL;
+    }
+
+/**
+ * analyzes an opened PDB file in bounded memory: a reader thread parses the file into chunks,
+ * while this thread folds every chunk into the running Cg/Rg statistics (see AtomStats), and
+ * into the hull summary of the atoms seen so far (see reduceToHull), from which Dmax is computed
+ * exactly at the end. only the chunks, the block being read, and the hull vertices are kept
+ * (and the atoms streamed since the last reduction, that are reduced once they are at least a
+ * chunk, and as many as the hull vertices: so, every reduction costs about as much as the atoms
+ * it adds, even when most of the atoms lie on the hull).
+ * @param file: a valid pointer to the file.
+ * @param stats: receives the statistics of the file's atoms.
+ * @param candidates: receives the hull vertices of the file's atoms (an initialized store).
+ * @param lineLen: receives the length of the ATOM line that is too short (if any).
+ * @return: 0 on success, or 3 (see LINE_LENGTH_ERR) if an ATOM line is too short.
+ */
+int streamPDBFile(FILE *const file, AtomStats *const stats, AtomStore *const candidates, \
+                  size_t *const lineLen)
+    {
+        AtomStream stream;
+        size_t i, chunkIdx = 0;
+        stream.file = file;
+        stream.finished = stream.errorNum = 0;
+        stream.lineLen = 0;
+        for (i = 0; i < STREAM_CHUNKS; ++i)
+        {
+            initAtomStore(&stream.chunks[i]);
+            reserveAtomStore(&stream.chunks[i], STREAM_CHUNK_ATOMS);
+            stream.full[i] = 0;
+        }
+        pthread_mutex_init(&stream.lock, NULL);
+        pthread_cond_init(&stream.changed, NULL);
+        pthread_t reader;
+        if (pthread_create(&reader, NULL, streamReader, &stream) != 0)
+        {
+            printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+        }
+
+        AtomStore work;
+        initAtomStore(&work);
+        size_t *vertices = NULL, verticesCapacity = 0, numOfHullAtoms = 0;
+        initAtomStats(stats);
+        candidates->count = 0;
+        while (1)
+        {
+            pthread_mutex_lock(&stream.lock);
+            while (!stream.full[chunkIdx] && !stream.finished)
+            {
+                pthread_cond_wait(&stream.changed, &stream.lock);
+            }
+            const int hasChunk = stream.full[chunkIdx];
+            pthread_mutex_unlock(&stream.lock);
+            if (!hasChunk)
+            {
+                break;
+            }
+            AtomStore *const chunk = &stream.chunks[chunkIdx];
+            accumulateAtomStats(stats, chunk, 0, chunk->count);
+            appendAtoms(candidates, chunk);
+            if (candidates->count - numOfHullAtoms >= numOfHullAtoms && \
+                candidates->count - numOfHullAtoms >= STREAM_CHUNK_ATOMS)
+            {
+                reduceToHull(candidates, &work, &vertices, &verticesCapacity);
+                numOfHullAtoms = candidates->count;
+            }
+            pthread_mutex_lock(&stream.lock);
+            stream.full[chunkIdx] = 0;
+            pthread_cond_broadcast(&stream.changed);
+            pthread_mutex_unlock(&stream.lock);
+            chunkIdx = (chunkIdx + 1) % STREAM_CHUNKS;
+        }
+        pthread_join(reader, NULL);
+        *lineLen = stream.lineLen;
+        if (candidates->count > numOfHullAtoms)
+        {
+            reduceToHull(candidates, &work, &vertices, &verticesCapacity);
+        }
+
+        pthread_mutex_destroy(&stream.lock);
+        pthread_cond_destroy(&stream.changed);
+        for (i = 0; i < STREAM_CHUNKS; ++i)
+        {
+            freeAtomStore(&stream.chunks[i]);
+        }
+        freeAtomStore(&work);
+        free(vertices);
+        return stream.errorNum;
+    }
+
+
+//----------------------ANALYZING FILES------------------------------------------------------------
+/**
+ * reads the PDB file called <fileName> into <atoms>, and prints its analyze results to <out>.
+ * @param fileName: the file name.
+ * @param atoms: a store to read the atoms into (its content is replaced).
+ * @param options: the program's options.
+ * @param out: the stream to print the analyze results to.
+ * @param err: the stream to print the error msgs to.
+ * @return 0 on success, else- the number of the error that occurred (see printError).
+ */
+int analyzeFile(const char *const fileName, AtomStore *const atoms, \
+                const Options *const options, FILE *const out, FILE *const err)
+    {
+        FILE *file = fopen(fileName, "r");
+        if (file == NULL)
+        {
+            printError(err, 1, fileName, 0); // err 1: couldn't read file
+            return 1;
+        }
+        //Iv'e assumed that the submitted files are in pdb format, else will result an
+        // unexpected behaviour( i.e: will analyze protein even if the file is not a
+        //pdb file)
+        size_t lineLen = 0;
+        AtomStats stats;
+        int errorNum = 0;
+        if (options->stream) // atoms receives the hull summary only
+        {
+            errorNum = streamPDBFile(file, &stats, atoms, &lineLen); // err 3: line too short
+        }
+        else
+        {
+            errorNum = options->cache ? readPDBFileCached(file, fileName, atoms, &lineLen) : \
+                                        readPDBFileMapped(file, atoms, &lineLen); // err 3
+            calculateAtomStats(atoms, &stats); // a single pass for both Cg and Rg
+        }
+        fclose(file);
+        if (!errorNum && !stats.count) //err 2: no atoms were detected
+        {
+            errorNum = 2;
+        }
+        if (errorNum)
+        {
+            printError(err, errorNum, fileName, lineLen);
+            return errorNum;
+        }
+        // the hull summary of a stream is searched exhaustively (it holds the hull vertices):
+        printAnalyzeResults(out, err, fileName, &stats, atoms, \
+                            options->stream ? DMAX_BRUTE : options->dMaxMode, \
+                            options->numOfDMaxThreads);
+        if (options->contactCutoff > 0)
+        {
+            printContacts(out, atoms, options->contactCutoff);
+        }
+        return 0;
+    }
+
+/**
+ * runs the job: analyzes its file into memory buffers (see FileJob).
+ * @param job: the job.
+ * @param atoms: a store to read the atoms into (its content is replaced).
+ * @param options: the program's options.
+ */
+void runFileJob(FileJob *const job, AtomStore *const atoms, const Options *const options)
+    {
+        FILE *out = open_memstream(&job->output, &job->outputSize);
+        FILE *err = open_memstream(&job->errors, &job->errorsSize);
+        if (out == NULL || err == NULL)
+        {
+            printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+        }
+        job->failed = (analyzeFile(job->fileName, atoms, options, out, err) != 0);
+        fclose(out);
+        fclose(err);
+    }
+
+/**
+ * the body of every worker thread of the pool: takes jobs until none is left.
+ * each worker reuses one atom store for all its jobs.
+ * @param arg: the FilePool.
+ * @return NULL.
+ */
+void *fileWorker(void *arg)
+    {
+        FilePool *const pool = (FilePool *)arg;
+        AtomStore atoms;
+        initAtomStore(&atoms);
+        while (1)
+        {
+            pthread_mutex_lock(&pool->lock);
+            const size_t idx = pool->nextJob++;
+            pthread_mutex_unlock(&pool->lock);
+            if (idx >= pool->numOfJobs)
+            {
+                break;
+            }
+            runFileJob(&pool->jobs[idx], &atoms, pool->options);
+            pthread_mutex_lock(&pool->lock);
+            pool->jobs[idx].done = 1;
+            pthread_cond_broadcast(&pool->jobDone);
+            pthread_mutex_unlock(&pool->lock);
+        }
+        freeAtomStore(&atoms);
+        return NULL;
+    }
+
+/**
+ * @return the number of online cores (at least 1).
+ */
+size_t numOfCores()
+    {
+        const long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        return (cores > 0) ? (size_t)cores : 1;
+    }
+
+/**
+ * @param options: the program's options.
+ * @param numOfFiles: the number of files to analyze.
+ * @return the number of worker threads to analyze <numOfFiles> files with.
+ */
+size_t numOfWorkers(const Options *const options, const size_t numOfFiles)
+    {
+        size_t workers = options->numOfJobs;
+        if (workers == 0)
+        {
+            workers = numOfCores();
+        }
+        return (workers < numOfFiles) ? workers : numOfFiles;
+    }
+
+/**
+ * analyzes all the supplied files in parallel (see FilePool), and prints their analyze results
+ * (and error msgs) in the order of <fileNames>, each as soon as it and all the files before it
+ * are done.
+ * @param fileNames: the files' names.
+ * @param numOfFiles: the number of files.
+ * @param options: the program's options.
+ * @return the number of files that could not be analyzed.
+ */
+size_t analyzeFiles(const char *fileNames[], const size_t numOfFiles, \
+                    const Options *const options)
+    {
+        FilePool pool;
+        pool.jobs = (FileJob *)calloc(numOfFiles, sizeof(FileJob));
+        const size_t workers = numOfWorkers(options, numOfFiles);
+        pthread_t *threads = (pthread_t *)malloc(workers * sizeof(pthread_t));
+        if (pool.jobs == NULL || threads == NULL)
+        {
+            printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+        }
+        size_t i, failures = 0;
+        for (i = 0; i < numOfFiles; ++i)
+        {
+            pool.jobs[i].fileName = fileNames[i];
+        }
+        pool.numOfJobs = numOfFiles;
+        pool.nextJob = 0;
+        // the cores that are left for every file split its brute force Dmax searches:
+        Options poolOptions = *options;
+        poolOptions.numOfDMaxThreads = (numOfCores() > workers) ? numOfCores() / workers : 1;
+        pool.options = &poolOptions;
+        pthread_mutex_init(&pool.lock, NULL);
+        pthread_cond_init(&pool.jobDone, NULL);
+        for (i = 0; i < workers; ++i)
+        {
+            if (pthread_create(&threads[i], NULL, fileWorker, &pool) != 0)
+            {
+                printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+            }
+        }
+        // prints the jobs in order:
+        for (i = 0; i < numOfFiles; ++i)
+        {
+            FileJob *const job = &pool.jobs[i];
+            pthread_mutex_lock(&pool.lock);
+            while (!job->done)
+            {
+                pthread_cond_wait(&pool.jobDone, &pool.lock);
+            }
+            pthread_mutex_unlock(&pool.lock);
+            fwrite(job->output, 1, job->outputSize, stdout);
+            fflush(stdout);
+            fwrite(job->errors, 1, job->errorsSize, stderr);
+            failures += job->failed;
+            free(job->output);
+            free(job->errors);
+        }
+        for (i = 0; i < workers; ++i)
+        {
+            pthread_join(threads[i], NULL);
         }
-        return atomCount;
+        pthread_mutex_destroy(&pool.lock);
+        pthread_cond_destroy(&pool.jobDone);
+        free(threads);
+        free(pool.jobs);
+        return failures;
+    }
+
+//----------------------BENCHMARK------------------------------------------------------------------
+/**
+ * @param phase: a benchmark phase.
+ * @return the name of the function that the phase times.
+ */
+const char *benchPhaseName(const BenchPhase phase)
+    {
+        switch (phase)
+        {
+            case(BENCH_READ):
+                return "readPDBFile";
+            case(BENCH_READ_MAPPED):
+                return "readPDBFileMapped";
+            case(BENCH_CENTER_OF_GRAVITY):
+                return "calculateCenterOfGravity";
+            case(BENCH_IONIC_RADIUS):
+                return "calculateIonicRadius";
+            default:
+                return "calculateDMax";
+        }
+    }
+
+/**
+ * runs a benchmark phase once on <target>.
+ * @param target: the benchmarked protein (the read phases replace its atoms).
+ * @param phase: the phase.
+ */
+void runBenchPhase(BenchTarget *const target, const BenchPhase phase)
+    {
+        float centerOfGravity[DIMENSIONS];
+        switch (phase)
+        {
+            case(BENCH_READ):
+                rewind(target->file);
+                target->errorNum = readPDBFile(target->file, &target->atoms, &target->lineLen);
+                break;
+            case(BENCH_READ_MAPPED):
+                target->errorNum = readPDBFileMapped(target->file, &target->atoms, \
+                                                     &target->lineLen);
+                break;
+            case(BENCH_CENTER_OF_GRAVITY):
+                calculateCenterOfGravity(&target->atoms, centerOfGravity);
+                target->sink = centerOfGravity[0];
+                break;
+            case(BENCH_IONIC_RADIUS):
+                target->sink = calculateIonicRadius(&target->atoms);
+                break;
+            default:
+                target->sink = calculateDMax(&target->atoms, target->options->dMaxMode, \
+                                             target->options->numOfDMaxThreads);
+                break;
+        }
+    }
+
+/**
+ * @return the time (in seconds) of a monotonic clock.
+ */
+double monotonicSeconds()
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (double)now.tv_sec + now.tv_nsec / 1e9;
+    }
+
+/**
+ * prints <string> to <out> as a JSON string.
+ * @param out: the stream to print to.
+ * @param string: the string.
+ */
+void printJsonString(FILE *const out, const char *string)
+    {
+        fputc('"', out);
+        for (; *string != '\0'; ++string)
+        {
+            if (*string == '"' || *string == '\\')
+            {
+                fprintf(out, "\\%c", *string);
+            }
+            else if ((unsigned char)*string < ' ')
+            {
+                fprintf(out, "\\u%04x", (unsigned)*string);
+            }
+            else
+            {
+                fputc(*string, out);
+            }
+        }
+        fputc('"', out);
+    }
+
+/**
+ * times every phase of the analysis of <target>: every phase is repeated for BENCH_MIN_SECONDS
+ * (at least once), and its mean wall time is printed to <out> as a JSON line:
+ * {"structure": <name>, "atoms": <num>, "phase": <function>, "runs": <num>, "seconds": <mean>,
+ *  "atoms_per_sec": <rate>, "peak_rss_kb": <the process' peak RSS once the phase is done>}
+ * @param out: the stream to print to.
+ * @param target: the benchmarked protein (its file is open, its atoms are empty).
+ * @return 0 on success, else- the number of the error that occurred (see printError).
+ */
+int benchmarkTarget(FILE *const out, BenchTarget *const target)
+    {
+        BenchPhase phase;
+        for (phase = BENCH_READ; phase < BENCH_NUM_OF_PHASES; ++phase)
+        {
+            const double start = monotonicSeconds();
+            double elapsed = 0;
+            size_t runs = 0;
+            do
+            {
+                runBenchPhase(target, phase);
+                ++runs;
+                elapsed = monotonicSeconds() - start;
+            } while (elapsed < BENCH_MIN_SECONDS && !target->errorNum);
+            if (!target->errorNum && !target->atoms.count) // err 2: no atoms were detected
+            {
+                target->errorNum = 2;
+            }
+            if (target->errorNum)
+            {
+                return target->errorNum;
+            }
+            struct rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+            const double seconds = elapsed / runs;
+            fprintf(out, "{\"structure\": ");
+            printJsonString(out, target->name);
+            fprintf(out, ", \"atoms\": %zd, \"phase\": \"%s\", \"runs\": %zd, \"seconds\": %.9f, "
+                    "\"atoms_per_sec\": %.1f, \"peak_rss_kb\": %ld}\n", target->atoms.count, \
+                    benchPhaseName(phase), runs, seconds, \
+                    (seconds > 0) ? target->atoms.count / seconds : 0, usage.ru_maxrss);
+            fflush(out);
+        }
+        return 0;
+    }
+
+/**
+ * writes a synthetic protein of <numOfAtoms> atoms to a temporary PDB file: copies of <atoms>,
+ * side by side on a cubic lattice centered at (0, 0, 0).
+ * @param atoms: the protein atoms the synthetic protein is built from (non empty).
+ * @param numOfAtoms: the num of atoms of the synthetic protein.
+ * @return the temporary file (rewound), or NULL if it could not be created.
+ */
+FILE *writeSyntheticProtein(const AtomStore *const atoms, const size_t numOfAtoms)
+    {
+        FILE *file = tmpfile();
+        if (file == NULL)
+        {
+            return NULL;
+        }
+        float low[DIMENSIONS], high[DIMENSIONS];
+        double spacing = 0;
+        size_t d, i, serial;
+        for (d = 0; d < DIMENSIONS; ++d)
+        {
+            low[d] = high[d] = atoms->coord[d][0];
+            for (i = 1; i < atoms->count; ++i)
+            {
+                low[d] = fminf(low[d], atoms->coord[d][i]);
+                high[d] = fmaxf(high[d], atoms->coord[d][i]);
+            }
+            spacing = fmax(spacing, (double)high[d] - low[d] + BENCH_COPY_MARGIN);
+        }
+        const size_t numOfCopies = (numOfAtoms + atoms->count - 1) / atoms->count;
+        size_t perEdge = 1;
+        while (perEdge * perEdge * perEdge < numOfCopies)
+        {
+            ++perEdge;
+        }
+        const double center = (perEdge - 1) * spacing / 2;
+        for (serial = 0; serial < numOfAtoms; ++serial)
+        {
+            const size_t copy = serial / atoms->count, atom = serial % atoms->count;
+            const size_t cell[DIMENSIONS] = {copy % perEdge, copy / perEdge % perEdge, \
+                                             copy / perEdge / perEdge};
+            double coord[DIMENSIONS];
+            for (d = 0; d < DIMENSIONS; ++d)
+            {
+                coord[d] = atoms->coord[d][atom] - low[d] + cell[d] * spacing - center;
+            }
+            fprintf(file, SYNTHETIC_ATOM_LINE, serial % BENCH_SERIAL_NUMBERS + 1, \
+                    copy % BENCH_SERIAL_NUMBERS, coord[0], coord[1], coord[2]);
+        }
+        if (fflush(file) != 0)
+        {
+            fclose(file);
+            return NULL;
+        }
+        rewind(file);
+        return file;
+    }
+
+/**
+ * benchmarks the analysis (see benchmarkTarget) of the supplied files, and then of synthetic
+ * proteins of BENCH_MIN_SYNTHETIC_ATOMS to BENCH_MAX_SYNTHETIC_ATOMS atoms (growing by
+ * BENCH_SYNTHETIC_SCALE) that are built from the first file (see writeSyntheticProtein).
+ * the proteins are benchmarked from the smallest to the largest, so the peak RSS grows with them.
+ * the results are printed to the stdout, and the error msgs to the stderr.
+ * @param fileNames: the files' names.
+ * @param numOfFiles: the number of files.
+ * @param options: the program's options.
+ * @return the number of files that could not be benchmarked.
+ */
+size_t runBenchmarks(const char *fileNames[], const size_t numOfFiles, \
+                     const Options *const options)
+    {
+        Options benchOptions = *options;
+        benchOptions.numOfDMaxThreads = numOfCores(); // the benchmark runs a single file at a time
+        AtomStore first;
+        initAtomStore(&first);
+        size_t i, failures = 0;
+        for (i = 0; i < numOfFiles; ++i)
+        {
+            BenchTarget target;
+            target.name = fileNames[i];
+            target.options = &benchOptions;
+            target.errorNum = 0;
+            target.lineLen = 0;
+            initAtomStore(&target.atoms);
+            target.file = fopen(fileNames[i], "r");
+            const int errorNum = (target.file == NULL) ? 1 : benchmarkTarget(stdout, &target);
+            if (errorNum)
+            {
+                printError(stderr, errorNum, fileNames[i], target.lineLen);
+                ++failures;
+            }
+            else if (first.count == 0)
+            {
+                first = target.atoms; // the synthetic proteins are built from it
+                initAtomStore(&target.atoms);
+            }
+            if (target.file != NULL)
+            {
+                fclose(target.file);
+            }
+            freeAtomStore(&target.atoms);
+        }
+        size_t numOfAtoms;
+        for (numOfAtoms = BENCH_MIN_SYNTHETIC_ATOMS; first.count > 0 && \
+             numOfAtoms <= BENCH_MAX_SYNTHETIC_ATOMS; numOfAtoms *= BENCH_SYNTHETIC_SCALE)
+        {
+            char name[sizeof("synthetic-") + 3 * sizeof(size_t)];
+            sprintf(name, "synthetic-%zd", numOfAtoms);
+            BenchTarget target;
+            target.name = name;
+            target.options = &benchOptions;
+            target.errorNum = 0;
+            target.lineLen = 0;
+            initAtomStore(&target.atoms);
+            target.file = writeSyntheticProtein(&first, numOfAtoms);
+            if (target.file == NULL)
+            {
+                printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+            }
+            if (benchmarkTarget(stdout, &target))
+            {
+                printError(stderr, target.errorNum, name, target.lineLen);
+                ++failures;
+            }
+            fclose(target.file);
+            freeAtomStore(&target.atoms);
+        }
+        freeAtomStore(&first);
+        return failures;
     }
 
 //-----------------------------------MAIN------------------------------------------------------
+/**
+ * parses the program's options (the arguments that start with "--") into <options>.
+ * @param argc: the number of the program's arguments
+ * @param argv: the program arguments.
+ * @param options: the options to fill (the defaults are kept for options that are not supplied).
+ * @return 1 if all the options are valid (and can be combined), 0 otherwise.
+ */
+int parseOptions(int argc, const char* argv[], Options *const options)
+    {
+        options->dMaxMode = DMAX_HULL;
+        options->numOfJobs = 0;
+        options->stream = 0;
+        options->cache = 0;
+        options->contactCutoff = 0;
+        options->bench = 0;
+        options->numOfDMaxThreads = 1;
+        int i;
+        for (i = 1; i < argc; ++i)
+        {
+            const char *arg = argv[i];
+            if (strncmp(arg, "--", 2) != 0)
+            {
+                continue;
+            }
+            if (!strcmp(arg, STREAM_OPTION))
+            {
+                options->stream = 1;
+                continue;
+            }
+            if (!strcmp(arg, CACHE_OPTION))
+            {
+                options->cache = 1;
+                continue;
+            }
+            if (!strcmp(arg, BENCH_OPTION))
+            {
+                options->bench = 1;
+                continue;
+            }
+            if (!strncmp(arg, CONTACTS_OPTION, strlen(CONTACTS_OPTION)))
+            {
+                char *remaining = NULL;
+                const double cutoff = strtod(arg + strlen(CONTACTS_OPTION), &remaining);
+                if (remaining == arg + strlen(CONTACTS_OPTION) || *remaining != '\0' || \
+                    !(cutoff > 0) || !isfinite(cutoff))
+                {
+                    return 0;
+                }
+                options->contactCutoff = cutoff;
+                continue;
+            }
+            if (!strncmp(arg, JOBS_OPTION, strlen(JOBS_OPTION)))
+            {
+                char *remaining = NULL;
+                const long jobs = strtol(arg + strlen(JOBS_OPTION), &remaining, 10);
+                if (*remaining != '\0' || jobs <= 0)
+                {
+                    return 0;
+                }
+                options->numOfJobs = (size_t)jobs;
+                continue;
+            }
+            if (strncmp(arg, DMAX_OPTION, strlen(DMAX_OPTION)) != 0)
+            {
+                return 0;
+            }
+            const char *const mode = arg + strlen(DMAX_OPTION);
+            if (!strcmp(mode, "hull"))
+            {
+                options->dMaxMode = DMAX_HULL;
+            }
+            else if (!strcmp(mode, "brute"))
+            {
+                options->dMaxMode = DMAX_BRUTE;
+            }
+            else if (!strcmp(mode, "check"))
+            {
+                options->dMaxMode = DMAX_CHECK;
+            }
+            else
+            {
+                return 0;
+            }
+        }
+        // contacts, the Dmax check and the cache need all the atoms:
+        return !(options->stream && (options->contactCutoff > 0 || \
+                                     options->dMaxMode == DMAX_CHECK || options->cache));
+    }
+
 /**
  * runs the program (see in file description).
  * @param argc: the number of the program's arguments
  * @param argv: the program arguments.
  * @return: when success- prints the protein analyze as mentioned above and exit with 0.
- *          else- prints an informative error massage to the stderr, and exit with EXIT_FAILURE.
+ *          else- prints an informative error massage to the stderr (for every file that could
+ *          not be analyzed), and exit with EXIT_FAILURE.
  */
 int main(int argc, const char* argv[])
     {
-        if (argc > 1)
+        Options options;
+        selectKernels();
+        if (argc > 1 && parseOptions(argc, argv, &options))
         {
-            float atoms[MAX_NUM_OF_ATOMS][DIMENSIONS];
+            // the files are the arguments that are not options (see parseOptions):
+            const char **fileNames = (const char **)malloc(argc * sizeof(const char *));
+            if (fileNames == NULL)
+            {
+                printErrorAndExit(4, NULL, NULL, (size_t)NULL);
+            }
+            size_t numOfFiles = 0;
             int i;
             for (i = 1; i < argc ; ++i)
             {
-                const char *fileName = argv[i];
-                FILE *file = fopen(fileName, "r");
-                if (file != NULL)
+                if (strncmp(argv[i], "--", 2) != 0)
                 {
-                    //Iv'e assumed that the submitted files are in pdb format, else will result an
-                    // unexpected behaviour( i.e: will analyze protein even if the file is not a
-                    //pdb file)
-                    size_t atomCount = readPDBFile(file, atoms);
-                        //err 2: no atoms were detected
-                    (!atomCount)? printErrorAndExit(2, file, fileName, (size_t)NULL) : NULL;
-                    printProteinAnalyze(fileName, atoms, atomCount);
-                    fclose(file);
-                    exit(EXIT_SUCCESS);
+                    fileNames[numOfFiles++] = argv[i];
                 }
-                printErrorAndExit(1, file, fileName, (size_t)NULL); // err 1: couldn't read file
             }
+            if (numOfFiles > 0)
+            {
+                const size_t failures = options.bench ? \
+                                        runBenchmarks(fileNames, numOfFiles, &options) : \
+                                        analyzeFiles(fileNames, numOfFiles, &options);
+                free(fileNames);
+                exit(failures ? EXIT_FAILURE : EXIT_SUCCESS);
+            }
+            free(fileNames);
         }
         printErrorAndExit(0, NULL, NULL, (size_t)NULL); //err 0: wrong usage
     }
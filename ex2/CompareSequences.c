@@ -8,34 +8,90 @@
  *        prints the Alignment score, followed by the alignments.
  *
  * @section DESCRIPTION
- * Input  :  <sequence file> <match> <mismatch> <gap>
+ * Input  :  [--linear-space | --banded | --score-only] [--kernel=<name>] [--threads=<n>]
+ *          [--matrix=<file>] [--gap-open=<n>] <sequence file> <match> <mismatch> <gap>
  *          where match, mismatch and gap are ints, sequence file is a txt file
  *          in linux. (for Windows txt file choose mode DEBUG. error:  will print excessive info)
- * Process: reads supplied sequence file, and keeps the sequences in a (linked)list of <Sequence>s.
+ *          --linear-space: align every couple in linear space (see alignLinearSpace), which is
+ *          also done without the option for couples whose table is too big (see
+ *          MAX_TABLE_CELLS).
+ *          --banded: align every couple with a band around the diagonal of the table, that is
+ *          widened until the alignment is surely optimal (see compareSequencesBanded). fast for
+ *          similar sequences, and the output is the same as without it.
+ *          --matrix=<file>: score the aligned chars by a substitution matrix (see readMatrixFile),
+ *          instead of match and mismatch (which still score the chars that aren't in it).
+ *          --gap-open=<n>: affine gaps (n <= 0): a gap of length L scores n + L * gap.
+ *          with either of them the couples are aligned in linear space (see alignAffine).
+ *          --score-only: print only the scores (see calScore), without the alignments.
+ *          --kmer=<k>: compare only the couples that share at least n distinct k-mers (k > 0)
+ *          (see prefilterCouples), where n is given by --min-kmers=<n> (n > 0, default 1). the
+ *          score of every other couple is printed as skipped, without an alignment.
+ *          --kernel=<auto|scalar|sse4.1|avx2|avx512|neon>: the kernel that calculates rows of
+ *          scores (see LastRowKernel). auto (the default) picks the widest that the cpu supports.
+ *          --threads=<n>: the num of threads (n > 0) that compare the couples (see CouplePool).
+ *          the default is the num of online cores. the output doesn't depend on it.
+ * Process: maps supplied sequence file to memory, and keeps the sequences in a contiguous arena,
+ *          indexed by an array of <Sequence>s (see SeqArena).
  *          for each couple of them calculates and prints the Alignment score. during the process,
- *          the algorithm keeps a table of <Cell>s, which allows it to remember the cell from which
- *          the score calculation came, and therefore allows it to traces back the calculations,
- *          and print the alignments.
+ *          the algorithm keeps the source of every cell of the table in 2 bits (see Traceback),
+ *          which allows it to remember the cell from which the score calculation came, and
+ *          therefore allows it to traces back the calculations,
+ *          and print the alignments. couples whose table is too big are aligned by Hirschberg's
+ *          divide and conquer algorithm instead, which keeps only two rows of scores.
+ *          the couples are compared in parallel (compile with -pthread).
  * Output : it prints the alignments score for each couple of sequences, followd by the alignments.
  *          when success- exit with 0, else- prints an informative error massage to the
  *          stderr, and exit with EXIT_FAILURE.
  */
  //-------------Includes---------------------------------------------------------------------------
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory.h>
 #include <assert.h>
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 //-----------Constants-----------------------------------------------------------------------------
 #define HEADER_PREFIX '>'
-#define MAX_LINE_LEN 100
+#define READ_CHUNK_LEN (1 << 16)
 #define SPACE_CHAR '-'
+#define LINEAR_SPACE_OPTION "--linear-space"
+#define SCORE_ONLY_OPTION "--score-only"
+#define OPTION_PREFIX "--"
+#define NUM_OF_ARGS 4
+#define MAX_TABLE_CELLS (1 << 28)
+#define KERNEL_OPTION "--kernel="
+#define AUTO_KERNEL "auto"
+#define SIMD_BYTES 64
+#define MIN_SIMD_LEN 64
+#define THREADS_OPTION "--threads="
+#define BANDED_OPTION "--banded"
+#define INITIAL_BAND 16
+#define MATRIX_OPTION "--matrix="
+#define GAP_OPEN_OPTION "--gap-open="
+#define NO_SCORE (INT_MIN / 2)
+#define KMER_OPTION "--kmer="
+#define MIN_KMERS_OPTION "--min-kmers="
+#define DEFAULT_MIN_KMERS 1
+#define KMER_HASH_BASE 1099511628211ULL
 //-------------Messages----------------------------------------------------------------------------
-#define USAGE_ERR_MSG fprintf(stderr,\
-                      "Usage: CompareSequences <sequence file> <match> <mismatch> <gap>\n")
+#define USAGE_ERR_MSG fprintf(stderr, "Usage: CompareSequences "\
+                      "[--linear-space | --banded | --score-only] "\
+                      "[--kernel=<auto|scalar|sse4.1|avx2|avx512|neon>] [--threads=<n>] "\
+                      "[--matrix=<file>] [--gap-open=<n>] [--kmer=<k> [--min-kmers=<n>]] "\
+                      "<sequence file> <match> <mismatch> <gap>\n")
 #define SEQ_NUM_ERR_MSG(fileName) fprintf(stderr,\
                                   "Error: Number of Sequences in %s < 2.\n", fileName)
+#define MATRIX_ERR_MSG(fileName) fprintf(stderr,\
+                                 "Error: %s is not a valid substitution matrix.\n", fileName)
 //-------------Macros-----------------------------------------------------------------------------
 #define MAX(X, Y) (((X) > (Y)) ? (X) : (Y))
+#define MIN(X, Y) (((X) < (Y)) ? (X) : (Y))
 #define TERNARY_MAX(X, Y, Z) (MAX(MAX(X, Y), Z))
 
 #ifdef DEBUG
@@ -50,104 +106,112 @@
 //--------------------------------------part 1 Logic---------------------------------------------
 
 /**
- * represents a sequence that has:
- * name: string(up to 99 chars != HEADER_PREFIX).
- * value: string of unknown length .
- * length: the length of the value(>0).
- * next: an address of another Sequence object(or Null). meant for ordering sequences objects.
+ * represents a sequence of a SeqArena, that has:
+ * name: string(!= HEADER_PREFIX), kept in the arena from <nameOffset>.
+ * value: string of unknown length, kept in the arena from <valOffset>.
+ * length: the length of the value.
+ * arena: the SeqArena that keeps the sequence.
  */
 typedef struct Sequence
 {
-    char *seqName;
-    char *seqVal;
+    const struct SeqArena *arena;
+    size_t nameOffset;
+    size_t valOffset;
     size_t seqLen;
-    struct Sequence* next;
 }Sequence;
 
 /**
- * initialize sequence object: assign memory and fill the fields in a trivial way.
- * @return the sequence we've created
+ * represents the sequences of a file: <chars> is a single contiguous arena that keeps the name and
+ * then the value of every sequence (each terminated by '\0'), and <seqs> is an index: the
+ * <seqNum> Sequences (in the order of the file), of which offsets and lengths are into <chars>.
+ * capacity: the num of Sequences that <seqs> has room for.
  */
-Sequence *initializeSeq()
+typedef struct SeqArena
 {
-    Sequence *seq = (Sequence *)malloc(sizeof(Sequence));
-    seq->seqName = NULL;
-    seq->seqVal = NULL;
-    seq->seqVal = 0;
-    seq->next = NULL;
-    return seq;
-}
+    char *chars;
+    size_t numOfChars;
+    Sequence *seqs;
+    size_t seqNum;
+    size_t capacity;
+}SeqArena;
 
 /**
- * sets the <name> as the <seq>'s seqName
- * @param seq: Sequence Object
- * @param name: string (without "\n" )
+ * initialize sequence arena: assign memory for <maxChars> chars, and no sequences.
+ * @param maxChars: the num of chars that the arena has room for.
+ * @return the arena we've created
  */
-void setSeqName(Sequence *seq, const char *const name)
-{
-    seq->seqName = (char *)malloc(strlen(name) + 1);
-    strcpy(seq->seqName, name);
-}
-
-/**
-* adds the supplied <len> to the <seq>'s len field.
-* @param seq: Sequence Object
-* @param len: size_t var
-*/
-void setSeqLen(Sequence *seq, size_t len)
+SeqArena *initializeSeqArena(const size_t maxChars)
 {
-    seq->seqLen += len;
+    SeqArena *arena = (SeqArena *)malloc(sizeof(SeqArena));
+    assert(arena != NULL);
+    arena->chars = (char *)malloc(maxChars);
+    assert(arena->chars != NULL);
+    arena->numOfChars = 0;
+    arena->seqs = NULL;
+    arena->seqNum = 0;
+    arena->capacity = 0;
+    return arena;
 }
 
 /**
- * sets the <seq>'s value to be val & updates it's len field accordingly
- * @param seq: Sequence Object
- * @param val: string (without "\n" or HEADER_PREFIX)
+ * adds a new sequence, called <name>, to the end of the <arena> (its value is empty, see
+ * addSeqVal). the value of the last sequence (if any) is terminated first.
+ * @param arena: SeqArena Object, that has room for the name and 2 more chars.
+ * @param name: the name (not necessarily terminated)
+ * @param nameLen: the length of the name
  */
-void setSeqVal(Sequence *seq, const char *const val)
+void addSeq(SeqArena *const arena, const char *const name, const size_t nameLen)
 {
-        size_t idx = 0;
-        if (seq->seqVal == NULL)
-        {
-            seq->seqVal = realloc(seq->seqVal, strlen(val) + 1);
-        }
-        else
-        {
-            idx = strlen(seq->seqVal);
-        }
-        strcpy(seq->seqVal + idx, val);
-        setSeqLen(seq, strlen(val));
+    if (arena->seqNum > 0)
+    {
+        arena->chars[arena->numOfChars++] = '\0';
+    }
+    if (arena->seqNum == arena->capacity)
+    {
+        arena->capacity = (arena->capacity == 0) ? 8 : 2 * arena->capacity;
+        arena->seqs = (Sequence *)realloc(arena->seqs, arena->capacity * sizeof(Sequence));
+        assert(arena->seqs != NULL);
+    }
+    Sequence *const seq = &arena->seqs[arena->seqNum++];
+    seq->arena = arena;
+    seq->nameOffset = arena->numOfChars;
+    memcpy(arena->chars + arena->numOfChars, name, nameLen);
+    arena->numOfChars += nameLen;
+    arena->chars[arena->numOfChars++] = '\0';
+    seq->valOffset = arena->numOfChars;
+    seq->seqLen = 0;
 }
 
 /**
- * sets <seq>'s next field to be <next> (if <seq> isn't null. if is: does nothing)
- * @param seq :
- * @param next : sequences object
+ * appends <val> to the value of the last sequence of the <arena> & updates it's len field
+ * accordingly
+ * @param arena: SeqArena Object, that has a sequence, and room for the value.
+ * @param val: the value (without "\n" or HEADER_PREFIX, not necessarily terminated)
+ * @param valLen: the length of the value
  */
-void setSeqNext(Sequence *seq, Sequence *next)
+void addSeqVal(SeqArena *const arena, const char *const val, const size_t valLen)
 {
-    if (seq != NULL)
-    {
-        seq->next = next;
-    }
+    memcpy(arena->chars + arena->numOfChars, val, valLen);
+    arena->numOfChars += valLen;
+    arena->seqs[arena->seqNum - 1].seqLen += valLen;
 }
 
 /**
  * @param seq: Sequence Object
  * @return the <seq>'s name (address)
 */
-char *getSeqName(const Sequence *const seq)
+const char *getSeqName(const Sequence *const seq)
 {
-    return seq->seqName;
+    return seq->arena->chars + seq->nameOffset;
 }
 
 /**
 * @param seq: Sequence Object
 * @return the <seq>'s value (address)
 */
-char *getSeqVal(const Sequence *const seq)
+const char *getSeqVal(const Sequence *const seq)
 {
-    return seq->seqVal;
+    return seq->arena->chars + seq->valOffset;
 }
 
 /**
@@ -160,322 +224,306 @@ size_t getSeqLen(const Sequence *const seq)
 }
 
 /**
- * @param seq: Sequence Object
- * @return the <seq>'s next
- */
-Sequence *getSeqNext(Sequence *seq)
-{
-    return seq->next;
-}
-
-/**
- * deletes the <seq>
- * @param seq: Sequence Object
+ * deletes the <arena> and all of its sequences
+ * @param arena: SeqArena Object
  */
-void eraseSequence(Sequence *seq)
+void eraseSeqArena(SeqArena *arena)
 {
-    char *seqName = getSeqName(seq);
-    char *seqVal = getSeqVal(seq);
-    free(seqName);
-    free(seqVal);
-    free(seq);
+    free(arena->chars);
+    free(arena->seqs);
+    free(arena);
 }
 
 
 /**
 * debugging helper: prints the array of sequences in the form: <name1,val1>...<nameN,valN>
-* @param sequences
+* @param arena
 */
-void printSeqArray(Sequence *head)
+void printSeqArray(const SeqArena *const arena)
 {
-    Sequence *curr = head;
-    while (curr != NULL)
+    size_t idx;
+    for (idx = 0; idx < arena->seqNum; ++idx)
     {
-        printf("<%s,%s> ", getSeqName(curr), getSeqVal(curr));
-        curr = getSeqNext(curr);
+        printf("<%s,%s> ", getSeqName(&arena->seqs[idx]), getSeqVal(&arena->seqs[idx]));
     }
     printf("\n");
 }
 
 //---------------Part 1 flow: read seq file & keep data-------------------------------------------
 /**
- * @param str: pointer to a valid char[]
- * @return str return <str> without NEW_LINE
+ * reads the whole file that <fd> refers to. regular files are mapped to memory, other files
+ * (pipes, for instance) are read into a buffer.
+ * @param fd: a file descriptor, open for reading.
+ * @param size: receives the size of the file.
+ * @param isMapped: receives 1 if the file was mapped (see munmap), 0 if it was read (see free).
+ * @return the content of the file, or NULL if it can't be read.
  */
-char *refineData(char *str)
+char *readWholeFile(const int fd, size_t *const size, int *const isMapped)
 {
-        return strtok(str, NEW_LINE);
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode) && fileStat.st_size > 0)
+    {
+        void *content = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (content != MAP_FAILED)
+        {
+            *size = (size_t)fileStat.st_size;
+            *isMapped = 1;
+            return (char *)content;
+        }
+    }
+    size_t capacity = READ_CHUNK_LEN, len = 0;
+    char *content = (char *)malloc(capacity);
+    ssize_t numOfRead;
+    while (content != NULL && (numOfRead = read(fd, content + len, capacity - len)) > 0)
+    {
+        len += (size_t)numOfRead;
+        if (len == capacity)
+        {
+            capacity *= 2;
+            char *const grown = (char *)realloc(content, capacity);
+            if (grown == NULL)
+            {
+                free(content);
+            }
+            content = grown;
+        }
+    }
+    if (content != NULL && numOfRead < 0)
+    {
+        free(content);
+        content = NULL;
+    }
+    *size = len;
+    *isMapped = 0;
+    return content;
 }
 
 /**
- * reads the file and parse it: creates Sequence objects out of the sequences mentioned in the
- * file and keeps them in an array, and returns that array's address.
- * (updates <seqNum> to represents the size of the array)
- * @param file: pointer to a valid file
- * @param seqNum: the size of the array
+ * reads the file that <fd> refers to and parse it: keeps the sequences mentioned in the file in a
+ * SeqArena, and returns it. lines may be of any length, and none of them is allocated: the
+ * names and values are copied from the file's content right into the arena, which is allocated
+ * once (the names and values are never longer than the file).
+ * @param fd: a file descriptor, open for reading.
+ * @return the arena, or NULL if the file can't be read.
  */
-Sequence *parseSeqFile(FILE *file, size_t *const seqNum)
+SeqArena *parseSeqFile(const int fd)
 {
-    char buff[MAX_LINE_LEN + NEW_LINE_LEN];
-    char *line = fgets(buff, MAX_LINE_LEN + NEW_LINE_LEN, file);
-    size_t toStart = 1;
-
-    Sequence *head = NULL;
-    Sequence *curr = head;
-    Sequence *seq = NULL;
-
-    while (line != NULL) // existing line
+    size_t size;
+    int isMapped;
+    const char *const content = readWholeFile(fd, &size, &isMapped);
+    if (content == NULL)
+    {
+        return NULL;
+    }
+    // every sequence takes the chars of its lines, and 2 terminators instead of its '>' and '\n':
+    SeqArena *arena = initializeSeqArena(size + 2);
+    const char *line = content, *const end = content + size;
+    while (line < end) // existing line
     {
+        const char *lineEnd = (const char *)memchr(line, '\n', (size_t)(end - line));
+        const char *const next = (lineEnd == NULL) ? end : lineEnd + 1;
+        lineEnd = (lineEnd == NULL) ? end : lineEnd;
+        while (lineEnd > line && memchr(NEW_LINE, lineEnd[-1], NEW_LINE_LEN) != NULL)
+        {
+            --lineEnd;
+        }
         // header line: seq name
-        if (toStart && buff[0] == HEADER_PREFIX)
+        if (line[0] == HEADER_PREFIX)
         {
-            //allocate memory & initialize new sequence:
-            seq = initializeSeq();
-            if (head == NULL)
-            {
-                head = seq;
-            }
-            setSeqNext(curr, seq);
-            curr = seq;
-            char *seqName = refineData(&buff[1]);
-            setSeqName(seq, seqName);
-
-            ++(*seqNum);
-            toStart = 0;
-            line = fgets(buff, MAX_LINE_LEN + NEW_LINE_LEN, file);
-            continue;
+            addSeq(arena, line + 1, (size_t)(lineEnd - line - 1));
         }
-            //co-responding seq val line(s):
-        else if (strcmp(line, NEW_LINE) != 0)
+        //co-responding seq val line(s):
+        else if (arena->seqNum > 0)
         {
-            char *seqVal = refineData(buff);
-            setSeqVal(seq, seqVal);
-            toStart = 1;
+            addSeqVal(arena, line, (size_t)(lineEnd - line));
         }
         //continue reading:
-        line = fgets(buff, MAX_LINE_LEN + NEW_LINE_LEN, file);
+        line = next;
+    }
+    if (arena->seqNum > 0)
+    {
+        arena->chars[arena->numOfChars++] = '\0';
+    }
+    if (isMapped)
+    {
+        munmap((void *)content, size);
+    }
+    else
+    {
+        free((void *)content);
     }
     if (DEBUG_PRINT) // prints the deq Array
     {
-        printSeqArray(head);
+        printSeqArray(arena);
     }
-    return head;
+    return arena;
 }
 
 //------------------------Part 2 Logic------------------------------------------------------------
 /**
-* represents a Cell in of a score table. Each cell has:
-* score: int.
-* source: pointer to another Cell object(or null). represents the cell from which we drew the
-*         data to calculate the score.
-* sourceChar: 'L', 'A' or 'D'. represents the location of the sourceCell.
-*            ('L': left of this cell, 'A': above this cell or
-*             'D': on diagonal -left&above- of this cell)
-*/
-typedef struct Cell
-{
-    struct Cell *sourceCell;
-    char sourceChar;
-    int score;
-}Cell;
-
-/**
- * updates the <cell>'s fields according to the supplied data (<sourceCell>, <score>)
- * @param cell : cell obj
- * @param sourceCell : pointer to another cell obj
- * @param sourceChar: char that represents the location of the <sourceCell> : 'L', 'A', or 'D'
- * @param score : int representing the cell's score
+ * represents the source of a cell in a score table: the cell from which we drew the data to
+ * calculate its score. NO_SOURCE only for the cell in [0][0].
+ * ('L': left of this cell, 'A': above this cell or 'D': on diagonal -left&above- of this cell)
  */
-void initializeCell(Cell *const cell, Cell *const sourceCell, \
-                    const char sourceChar, const int score)
-{
-    cell->sourceCell = sourceCell;
-    cell->sourceChar = sourceChar;
-    cell->score = score;
-}
+typedef enum Source {NO_SOURCE = 0, SOURCE_D = 1, SOURCE_L = 2, SOURCE_A = 3}Source;
 
 /**
-* @param cell: Cell object
-* @return the score for the alignment of  the cell.
-*/
-int getScore(Cell *cell)
-{
-    return cell->score;
-}
-
-    /**
-* @param cell: Cell object
-* @return the sourceChar of the cell.
-*/
-char getSourceChar(Cell *cell)
+ * represents the traceback of a score table of dimension: <rows> X <cols>. the source of every
+ * cell (see Source) is packed into 2 bits of a contiguous bitmap, row after row, so the table
+ * takes a quarter of a byte per cell. the scores themselves aren't kept: while the table is
+ * filled only 2 rows of them are needed (see fillTraceback), and the source of a cell is all that
+ * the traceback needs.
+ * a banded traceback keeps only the cells whose diagonal (col - row) is in
+ * [firstDiagonal, firstDiagonal + width), i.e: <width> cells of every row (see
+ * fillBandedTraceback), else all the <width> = <cols> cells of every row are kept.
+ */
+typedef struct Traceback
 {
-    return cell->sourceChar;
-}
+    unsigned char *sources;
+    size_t rows;
+    size_t cols;
+    size_t width;
+    long firstDiagonal;
+    int banded;
+}Traceback;
 
 /**
-* @param cell: Cell object
-* @return the sourceCell of the cell.
-*/
-Cell *getSource(Cell *cell)
-{
-    return cell->sourceCell;
-}
-
-    /**
-     * calculates: Table[i][j] = Table[i-1][j] + gap
-     * @param table: a valid table ( a matrix of <Cell> objects, of dimension: <rows> X <cols>)
-     * @param row: the row of the cell (i)
-     * @param col: the col of the cell {j)
-     * @param g: gap parameter
-     * @return the calculation's result.
-     */
-int calByAbove(Cell **table, const size_t row, const size_t col, const int g)
+ * creates a traceback of dimension: <rows> X <cols>, with no sources.
+ * @param rows: num of rows in the table.
+ * @param cols: num of cols in the table.
+ * @return the traceback.
+ */
+Traceback *createTraceback(const size_t rows, const size_t cols)
 {
-    return getScore(&table[row - 1][col]) + g;
+    Traceback *traceback = (Traceback *)malloc(sizeof(Traceback));
+    assert(traceback != NULL);
+    traceback->sources = (unsigned char *)calloc((rows * cols + 3) / 4, 1);
+    assert(traceback->sources != NULL);
+    traceback->rows = rows;
+    traceback->cols = cols;
+    traceback->width = cols;
+    traceback->firstDiagonal = 0;
+    traceback->banded = 0;
+    return traceback;
 }
 
 /**
-* calculates: Table[i][j] = Table[i][j-1] + gap
-* @param table: a valid table (a matrix of <Cell> objects, of dimension: <rows> X <cols>)
-* @param row: the row of the cell (i)
-* @param col: the col of the cell {j)
-* @param g: gap parameter
-* @return the calculation's result.
-*/
-int calByLeft(Cell **table, const size_t row, const size_t col, const int g)
+ * creates a banded traceback of dimension: <rows> X <cols>, with no sources, that keeps the cells
+ * whose diagonal (col - row) is in [<firstDiagonal>, <firstDiagonal> + <width>).
+ * @param rows: num of rows in the table.
+ * @param cols: num of cols in the table.
+ * @param firstDiagonal: the first diagonal of the band.
+ * @param width: num of diagonals in the band.
+ * @return the traceback.
+ */
+Traceback *createBandedTraceback(const size_t rows, const size_t cols, const long firstDiagonal, \
+                                 const size_t width)
 {
-    return getScore(&table[row][col - 1]) + g;
+    Traceback *traceback = createTraceback(rows, width);
+    traceback->cols = cols;
+    traceback->firstDiagonal = firstDiagonal;
+    traceback->banded = 1;
+    return traceback;
 }
 
 /**
-* calculates and returns: if <seq1Val>[i] = <seq2Val>[j]: Table[i][j] = Table[i-1][j-1] + match.
-*                             else: Table[i][j] = Table[i-1][j-1] + mismatch.
-* @param table: a valid table (a matrix of <Cell> objects, of dimension: <rows> X <cols>)
-* @param row: the row of the cell (i)
-* @param col: the col of the cell {j)
-* @param seq1Val: string representing the value field of a Sequence object
-* @param seq2Val: string representing the value field of a Sequence object
-* @param m: match parameter
-* @param s: mismatch parameter
-* @return the calculation's result.
-*/
-int calByDiagonal(Cell **table, const size_t row, const size_t col, const char *const seq1Val, \
-                  const char *const seq2Val, const int m, const int s)
+ * @param traceback: a valid traceback.
+ * @param row: the row of the cell
+ * @param col: the col of the cell (in the band, if the traceback is banded)
+ * @return the index of the cell in [<row>][<col>] in the bitmap of the sources.
+ */
+size_t getCellIndex(const Traceback *const traceback, const size_t row, const size_t col)
 {
-    if (seq1Val[row - 1] == seq2Val[col - 1])
+    if (traceback->banded)
     {
-        return getScore(&table[row - 1][col - 1]) + m;
+        return row * traceback->width + (size_t)((long)col - (long)row - traceback->firstDiagonal);
     }
-    return getScore(&table[row - 1][col - 1]) + s;
+    return row * traceback->width + col;
 }
 
-    /**
-     * initialize cell in <table>[<row>][<col>], based on other cells attributes.
-     * @param table: a valid table (a matrix of <Cell> objects, of dimension: <rows> X <cols>)
-     * @param row: the row of the cell
-     * @param col: the col of the cell
-     * @param seq1Val: string representing the value field of a Sequence object
-     * @param seq2Val: string representing the value field of a Sequence object
-     * @param m: match parameter
-     * @param s : mismatch parameter
-     * @param g : gap parameter
-     */
-void setCell(Cell **table, const size_t row, const size_t col, const char *const seq1Val, \
-             const char *const seq2Val, const int m, const int s, const int g)
-{
-    // calculate cell's score
-    int leftScore = calByLeft(table, row, col, g);
-    int aboveScore = calByAbove(table, row, col, g);
-    int diagonalScore = calByDiagonal(table, row, col, seq1Val, seq2Val, m, s);
-    int max = TERNARY_MAX(leftScore, aboveScore, diagonalScore);
-    // calculate cell's source:
-    Cell *sourceCell = NULL;
-    char sourceChar = 0;
-    if(max == diagonalScore)
-    {
-        sourceCell = &table[row - 1][col - 1];
-        sourceChar = 'D';
-    }
-    else if(max == leftScore)
-    {
-        sourceCell = &table[row][col - 1];
-        sourceChar = 'L';
-    }
-    else if(max == aboveScore)
-    {
-        sourceCell = &table[row - 1][col];
-        sourceChar = 'A';
-    }
-
-    //sets cell:
-    initializeCell(&table[row][col], sourceCell, sourceChar, max);
-}
 /**
- * creates a table: a matrix of <Cell> objects, of dimension: <rows> X <cols>.
- * @param rows: num of rows in <table>.
- * @param cols: num of cols in <table>.
- * @return the table.
+ * sets the source of the cell in [<row>][<col>] (which has no source yet).
+ * @param traceback: a valid traceback.
+ * @param row: the row of the cell
+ * @param col: the col of the cell
+ * @param source: the source of the cell.
  */
-Cell **createTable(const size_t rows, const size_t cols)
+void setSource(Traceback *const traceback, const size_t row, const size_t col, const Source source)
 {
-    Cell **table;
-    table =	(Cell**)malloc(rows * sizeof(Cell*));
-    size_t r;
-    for	(r = 0;	r < rows ; r++)
-    {
-        table[r] = (Cell*)malloc(cols * sizeof(Cell));
-    }
-    return table;
+    const size_t idx = getCellIndex(traceback, row, col);
+    traceback->sources[idx / 4] |= (unsigned char)(source << (2 * (idx % 4)));
 }
 
 /**
- * initializes the table, i.e: the Cells in the first row and column.
- * @param table: the table to initialize.
- * @param rows: num of rows in <table>.
- * @param cols: num of cols in <table>.
- * @param g: the gap parameter.
+ * @param traceback: a valid traceback.
+ * @param row: the row of the cell
+ * @param col: the col of the cell
+ * @return the sourceChar of the cell in [<row>][<col>]: 'L', 'A', 'D' (or 0 if it has no source).
  */
-void initializeTable(Cell **const table, const size_t rows, const size_t cols, const int g)
+char getSourceChar(const Traceback *const traceback, const size_t row, const size_t col)
 {
-    size_t r, c;
-    initializeCell(&table[0][0], NULL, 0, 0);
-    for (r = 1; r < rows; ++r)// initialize first col
-    {
-        initializeCell(&table[r][0], NULL, 0, (int)r * g);
-    }
-    for (c = 1; c < cols; ++c) // initialize first row
-    {
-        initializeCell(&table[0][c], NULL, 0, (int)c * g);
-    }
+    static const char sourceChars[] = {0, 'D', 'L', 'A'};
+    const size_t idx = getCellIndex(traceback, row, col);
+    return sourceChars[(traceback->sources[idx / 4] >> (2 * (idx % 4))) & 3];
 }
 
 /**
- * fills the table: updates all cells and their attributes.
- * @param table: a valid table (a matrix of <Cell> objects)
- * @param seq2: pointer to a Sequence Object.
+ * fills the traceback: calculates the scores of all cells, row after row, and sets their sources.
+ * Table[i][j] is the max of Table[i][j-1] + gap, Table[i-1][j] + gap and Table[i-1][j-1] + match
+ * (if <seq1Val>[i] = <seq2Val>[j], else + mismatch). ties are broken towards 'D', then 'L'.
+ * @param traceback: a traceback of dimension: (len of seq1 + 1) X (len of seq2 + 1), with no
+ *                   sources.
+ * @param seq1: pointer to a Sequence Object.
  * @param seq2: pointer to a Sequence Object.
  * @param m: match parameter
  * @param s : mismatch parameter
  * @param g : gap parameter
+ * @return the score of the last cell, i.e. the alignment score.
  */
-void fillTable(Cell **const table, const Sequence *const seq1, const Sequence *const seq2,\
-               const int m, const int s, const int g)
+int fillTraceback(Traceback *const traceback, const Sequence *const seq1, \
+                  const Sequence *const seq2, const int m, const int s, const int g)
 {
-    const size_t rows = getSeqLen(seq1) + 1;
-    const size_t cols = getSeqLen(seq2) + 1;
+    const size_t rows = traceback->rows;
+    const size_t cols = traceback->cols;
     const char *const seq1Val = getSeqVal(seq1);
     const char *const seq2Val = getSeqVal(seq2);
-
-    initializeTable(table, rows, cols, g);
+    int *above = (int *)malloc(cols * sizeof(int));
+    int *curr = (int *)malloc(cols * sizeof(int));
+    assert(above != NULL && curr != NULL);
     size_t r, c;
+    curr[0] = 0;
+    for (c = 1; c < cols; ++c) // initialize first row
+    {
+        curr[c] = (int)c * g;
+        setSource(traceback, 0, c, SOURCE_L);
+    }
     for (r = 1; r < rows; ++r)
     {
+        int *const swap = above;
+        above = curr;
+        curr = swap;
+        curr[0] = (int)r * g; // initialize first col
+        setSource(traceback, r, 0, SOURCE_A);
         for (c = 1 ; c < cols; ++c)
         {
-            setCell(table, r, c, seq1Val, seq2Val, m, s, g);
+            const int leftScore = curr[c - 1] + g;
+            const int aboveScore = above[c] + g;
+            const int diagonalScore = above[c - 1] + ((seq1Val[r - 1] == seq2Val[c - 1]) ? m : s);
+            const int max = TERNARY_MAX(leftScore, aboveScore, diagonalScore);
+            Source source = SOURCE_A;
+            if (max == diagonalScore)
+            {
+                source = SOURCE_D;
+            }
+            else if (max == leftScore)
+            {
+                source = SOURCE_L;
+            }
+            curr[c] = max;
+            setSource(traceback, r, c, source);
             if(DEBUG_PRINT) //prints table
             {
-                printf("%d(%c) ", getScore(&table[r][c]), getSourceChar(&table[r][c]));
+                printf("%d(%c) ", max, getSourceChar(traceback, r, c));
             }
         }
         if(DEBUG_PRINT) // prints table
@@ -483,231 +531,1876 @@ void fillTable(Cell **const table, const Sequence *const seq1, const Sequence *c
             printf("\n");
         }
     }
+    const int score = curr[cols - 1];
+    free(above);
+    free(curr);
+    return score;
 }
 
-
 /**
-* frees the memory allocated to <table>
-* @param table: the table to initialize.
-* @param rows: num of rows in <table>.
+* frees the memory allocated to <traceback>
+* @param traceback: the traceback to erase.
 */
-void eraseTable(Cell **table, const size_t rows)
+void eraseTraceback(Traceback *traceback)
 {
-    size_t r;
-    for(r =	0; r < rows; ++r)
-    {
-        free(table[r]);
-        table[r] = NULL;
-    }
-    free(table);
+    free(traceback->sources);
+    free(traceback);
 }
 
-//-----------------------Part 2 flow: sequences compare-------------------------------------------
-
+//------------------------Part 2 Logic: banded table----------------------------------------------
 /**
- * prints the alignment score for the sequences called <seq1Name>, <seq2Name>,
- * in a specific syntax (see implementation).
- * @param seq1Name: sequence object's name (address).
- * @param seq2Name: sequence object's name (address).
- * @param score: the alignment score for the sequences called <seq1Name>, <seq2Name>.
+ * fills the banded traceback: calculates the scores of the cells of the band, row after row, and
+ * sets their sources, as fillTraceback does, except that the cells out of the band are ignored
+ * (as if their score was -infinity). the scores of a row are kept by their diagonal, so the
+ * cell in [r][c] (diagonal d = c - r) draws from the cells of diagonals d - 1 (left) in its row,
+ * and d (diagonal) and d + 1 (above) in the row above.
+ * @param traceback: a banded traceback of dimension: (len of seq1 + 1) X (len of seq2 + 1), with
+ *                   no sources, whose band contains the diagonals 0 and
+ *                   (len of seq2 - len of seq1).
+ * @param seq1: pointer to a Sequence Object.
+ * @param seq2: pointer to a Sequence Object.
+ * @param m: match parameter
+ * @param s : mismatch parameter
+ * @param g : gap parameter
+ * @return the score of the last cell, i.e. the best score of the alignments within the band.
  */
-void printScore(const char *const seq1Name, const char *const seq2Name, const int score)
+int fillBandedTraceback(Traceback *const traceback, const Sequence *const seq1, \
+                        const Sequence *const seq2, const int m, const int s, const int g)
 {
-    printf ("Score for alignment of %s to %s is %d\n", seq1Name, seq2Name, score);
+    const size_t rows = traceback->rows;
+    const long lastCol = (long)traceback->cols - 1;
+    const long width = (long)traceback->width;
+    const long firstDiagonal = traceback->firstDiagonal;
+    const char *const seq1Val = getSeqVal(seq1);
+    const char *const seq2Val = getSeqVal(seq2);
+    int *above = (int *)malloc(width * sizeof(int));
+    int *curr = (int *)malloc(width * sizeof(int));
+    assert(above != NULL && curr != NULL);
+    size_t r;
+    long t;
+    for (r = 0; r < rows; ++r)
+    {
+        int *const swap = above;
+        above = curr;
+        curr = swap;
+        // the cells of the row in the table: cols [first, last] of the band's [0, width):
+        const long first = MAX(0, -firstDiagonal - (long)r);
+        const long last = MIN(width - 1, lastCol - firstDiagonal - (long)r);
+        for (t = first; t <= last; ++t)
+        {
+            const long c = (long)r + firstDiagonal + t;
+            int max = 0;
+            Source source = NO_SOURCE;
+            if (r > 0 && c > 0) // diagonal
+            {
+                max = above[t] + ((seq1Val[r - 1] == seq2Val[c - 1]) ? m : s);
+                source = SOURCE_D;
+            }
+            if (t > first && (source == NO_SOURCE || curr[t - 1] + g > max)) // left
+            {
+                max = curr[t - 1] + g;
+                source = SOURCE_L;
+            }
+            if (r > 0 && t + 1 < width && (source == NO_SOURCE || above[t + 1] + g > max)) // above
+            {
+                max = above[t + 1] + g;
+                source = SOURCE_A;
+            }
+            curr[t] = max;
+            if (source != NO_SOURCE)
+            {
+                setSource(traceback, r, (size_t)c, source);
+            }
+        }
+    }
+    const int score = curr[lastCol - firstDiagonal - (long)(rows - 1)];
+    free(above);
+    free(curr);
+    return score;
 }
 
-void analyzeSourceChar(const char sourceChar, char *const seq1Final, char *const seq2Final,\
-                       const char *const seq1Val, const char *const seq2Val, size_t *i, size_t *j)
+/**
+ * calculates an upper bound on the scores of the alignments of sequences of lengths <len1>,
+ * <len2>, whose path leaves the band of the diagonals [min(0, d) - <k>, max(0, d) + <k>], where
+ * d = len2 - len1. such a path has at least |d| + 2 * (k + 1) gaps, and (len1 + len2 - gaps) / 2
+ * pairs, each adds at most max(m, s).
+ * @param len1: length of seq1.
+ * @param len2: length of seq2.
+ * @param k: the band's margin around the diagonals 0 and d.
+ * @param m: match parameter
+ * @param s : mismatch parameter
+ * @param g : gap parameter
+ * @return the upper bound, or LONG_MIN if no path leaves the band.
+ */
+long calOutOfBandBound(const size_t len1, const size_t len2, const size_t k, const int m, \
+                       const int s, const int g)
 {
-    if (sourceChar == 'D')
-    {
-        seq1Final[0] = seq1Val[*i];
-        seq2Final[0] = seq2Val[*j];
-        seq1Final[1] = seq2Final[1] = '\0';
-        --*i, --*j;
-    }
-    else if (sourceChar == 'L')
+    const long total = (long)(len1 + len2);
+    const long minGaps = labs((long)len2 - (long)len1) + 2 * ((long)k + 1);
+    if (minGaps > total)
     {
-        seq1Final[0] = SPACE_CHAR;
-        seq2Final[0] = seq2Val[*j];
-        seq1Final[1] = seq2Final[1] = '\0';
-        --*j;
+        return LONG_MIN;
     }
-    else if (sourceChar == 'A')
+    const long maxPair = MAX(m, s);
+    if (2 * (long)g > maxPair) // a gap is worth more than half a pair: the more gaps the better
     {
-        seq1Final[0] = seq1Val[*i];
-        seq2Final[0] = SPACE_CHAR;
-        seq1Final[1] = seq2Final[1] = '\0';
-        --*i;
+        return total * g;
     }
+    return (total - minGaps) / 2 * maxPair + minGaps * g;
 }
 
+//------------------------Part 2 Logic: linear space----------------------------------------------
 /**
- * create a alignment from the 2 inputs (the alignment params), and frees the memory that held them
- * @param paramLen: the length of the 2 parameters
- * @param seq1Aligned : the aligned param
- * @param seq2Aligned: the aligned param
- * @return the alignment (string of the form <seq1Aligned>\n<seq2Alignment>\n)
+ * represents the way the couples of sequences are aligned:
+ * FULL_TABLE: with the traceback of the full table (see Traceback), unless it is too big.
+ * LINEAR_SPACE: with Hirschberg's divide and conquer algorithm (see alignLinearSpace).
+ * SCORE_ONLY: not aligned at all, only their score is calculated (see calScore).
+ * BANDED: with the traceback of a band around the diagonal, which is widened until it surely
+ *         contains the optimal alignment (see compareSequencesBanded).
  */
-char *createAlignment(const size_t paramLen, char *const seq1Aligned, char *const seq2Aligned)
+typedef enum AlignMode
 {
-    char *alignment = (char *)malloc(sizeof(char) * (2 * paramLen + 1));
-    strcpy(alignment, seq1Aligned);
-    strcat(alignment, "\n");
-    strcat(alignment, seq2Aligned);
-    strcat(alignment, "\n");
-    free(seq1Aligned);
-    free(seq2Aligned);
-    return alignment;
-}
-   /**
-    * calculate the alignment for the sequences in a specific syntax (see implementation).
-    * @param seq1 : address of a sequence object.
-    * @param seq2 : address of a sequence object.
-    * @param table: a valid table (a matrix of <Cell> objects, of dimension: <rows> X <cols>)
-    * @param rows: num of rows in <table>.
-    * @param cols: num of cols in <table>.
-    * @return the alignment.
-    */
-char *calAlignment(const Sequence *const seq1, const Sequence *const seq2,\
-                   Cell **table, const size_t rows, const size_t cols)
+    FULL_TABLE,
+    LINEAR_SPACE,
+    SCORE_ONLY,
+    BANDED
+}AlignMode;
+
+/**
+ * @param a: char of a sequence value
+ * @param b: char of a sequence value
+ * @param m: match parameter
+ * @param s: mismatch parameter
+ * @return the score for aligning <a> with <b>: <m> if they match, <s> otherwise.
+ */
+int calSubstitution(const char a, const char b, const int m, const int s)
 {
-    //initializes vars:
-    char *seq1Final = NULL, *seq2Final = NULL ;
-    char *seq1Add = "", *seq2Add = "";
-    Cell *currCell = &(table[rows - 1][cols - 1] );
-    size_t i = getSeqLen(seq1) - 1;
-    size_t j = getSeqLen(seq2) - 1;
-    const char *const seq1Val = getSeqVal(seq1);
-    const char *const seq2Val = getSeqVal(seq2);
-    size_t idx = 1;
+    return (a == b) ? m : s;
+}
 
-    while (currCell != NULL)
+/**
+ * calculates the last row of the score table of <x> (the rows) and <y> (the cols), keeping a
+ * single row of scores: the row is updated in place, from the first row to the last.
+ * @param x: the chars of the rows.
+ * @param xLen: the length of <x>.
+ * @param y: the chars of the cols.
+ * @param yLen: the length of <y>.
+ * @param reverse: 1 to align the reversed <x> and <y> (i.e: the table from its end), else 0.
+ * @param m: match parameter
+ * @param s : mismatch parameter
+ * @param g : gap parameter
+ * @param row: array of size <yLen> + 1, receives the last row.
+ */
+void calLastRow(const char *const x, const size_t xLen, const char *const y, const size_t yLen,\
+                const int reverse, const int m, const int s, const int g, int *const row)
+{
+    size_t i, j;
+    for (j = 0; j <= yLen; ++j)
     {
-        char sourceChar = getSourceChar(currCell);
-        //set add1, add2 to hold the alignment so far (from end until this point):
-        seq1Final = (char *)malloc(sizeof(char) + idx);
-        seq2Final = (char *)malloc(sizeof(char) + idx);
-
-        analyzeSourceChar(sourceChar, seq1Final, seq2Final, seq1Val, seq2Val, &i, &j);
-
-        strcat(seq1Final, seq1Add);
-        strcat(seq2Final, seq2Add);
-
-        seq1Add = seq1Final;
-        seq2Add = seq2Final;
-        //move to next iter:
-        currCell = getSource(currCell);
-        ++idx;
+        row[j] = (int)j * g;
+    }
+    for (i = 1; i <= xLen; ++i)
+    {
+        const char xChar = reverse ? x[xLen - i] : x[i - 1];
+        int diagonal = row[0]; // the score above and left of the current cell
+        row[0] = (int)i * g;
+        for (j = 1; j <= yLen; ++j)
+        {
+            const char yChar = reverse ? y[yLen - j] : y[j - 1];
+            const int above = row[j];
+            row[j] = TERNARY_MAX(diagonal + calSubstitution(xChar, yChar, m, s), row[j - 1] + g,\
+                                 above + g);
+            diagonal = above;
+        }
     }
-    //creates alignment from the 2 aligned params, frees their memory, and return the new alignment
-    return createAlignment(idx, seq1Add, seq2Add);
 }
 
-    /**
-     * calculates and prints the alignment score for the sequences called <seq1Name>, <seq2Name>,
-     * and returns the alignment itself.
-     * @param seq1 : address of a sequence object.
-     * @param seq2 : address of a sequence object.
-     * @param m : match parameter
-     * @param s : mismatch parameter
-     * @param g : gap parameter
-     * @return the alignment.
-     */
-char *compareSequences(const Sequence *const seq1, const Sequence *const seq2,\
-                       const int m, const int s, const int g)
+//------------------------Part 2 Logic: SIMD kernels----------------------------------------------
+/**
+ * represents a kernel that calculates the last row of a score table (see calLastRow, which is
+ * the scalar kernel, for the parameters).
+ */
+typedef void (*LastRowKernel)(const char *const x, const size_t xLen, const char *const y, \
+                              const size_t yLen, const int reverse, const int m, const int s, \
+                              const int g, int *const row);
+
+/**
+ * the kernel that calculates the rows of scores of the alignments (see selectKernel).
+ */
+static LastRowKernel lastRowKernel = calLastRow;
+
+#if defined(__GNUC__)
+/**
+ * represents the input of the anti diagonal kernels: copies of the sequences, padded by the
+ * widest vector (SIMD_BYTES), of which the cols' chars are reversed (so that the chars of the
+ * cells of an anti diagonal are contiguous in both).
+ * x: the chars of the rows.
+ * yReversed: the chars of the cols, from the last to the first.
+ * diagonals: 3 anti diagonals of scores (of type int16_t if narrow, else int32_t).
+ * stride: the num of scores in every anti diagonal.
+ * narrow: 1 if all the scores of the table fit in 16 bits, else 0.
+ */
+typedef struct DiagonalInput
 {
-    const size_t rows = getSeqLen(seq1) + 1;
-    const size_t cols = getSeqLen(seq2) + 1;
-    const char *const seq1Name = getSeqName(seq1);
-    const char *const seq2Name = getSeqName(seq2);
-    Cell **table = createTable(rows, cols);
-    fillTable(table, seq1, seq2, m, s, g);
-    const int score = getScore(&table[rows - 1][cols - 1]);
-    printScore(seq1Name, seq2Name, score);
-    char *alignment = calAlignment(seq1, seq2, table, rows, cols);
-    eraseTable(table, rows);
-    return alignment;
-}
+    char *x;
+    char *yReversed;
+    void *diagonals;
+    size_t stride;
+    int narrow;
+}DiagonalInput;
 
-//----------------------------Running the program--------------------------------------------------
 /**
- * @param str some string
- * @param isInteger
- * @return the converted int that str represents (no change to isInteger).
- * if str doesn't represents int, isInteger will be 0.
+ * prepares the input of the anti diagonal kernels (see calLastRow for the parameters).
+ * @param input: receives the input (must be freed with freeDiagonalInput).
  */
-long stringToInt(const char *const str, size_t *const isInteger)
+void initDiagonalInput(DiagonalInput *const input, const char *const x, const size_t xLen, \
+                       const char *const y, const size_t yLen, const int reverse, const int m, \
+                       const int s, const int g)
 {
-    char *remaining = NULL;
-    long result = strtol(str, &remaining, 10);
-    if (strcmp(remaining, "") != 0)
+    const int maxStep = MAX(MAX(abs(m), abs(s)), abs(g));
+    size_t idx;
+    input->narrow = ((double)(xLen + yLen + 2) * maxStep < INT16_MAX);
+    input->stride = xLen + 1 + SIMD_BYTES / sizeof(int16_t); // room for the lanes that overrun
+    input->x = (char *)malloc(xLen + SIMD_BYTES);
+    input->yReversed = (char *)malloc(yLen + SIMD_BYTES);
+    input->diagonals = malloc(3 * input->stride * (input->narrow ? sizeof(int16_t) : \
+                                                                   sizeof(int32_t)));
+    for (idx = 0; idx < xLen; ++idx)
     {
-        *isInteger = 0;
+        input->x[idx] = reverse ? x[xLen - 1 - idx] : x[idx];
     }
-    return result;
+    for (idx = 0; idx < yLen; ++idx)
+    {
+        input->yReversed[idx] = reverse ? y[idx] : y[yLen - 1 - idx];
+    }
+    memset(input->x + xLen, 0, SIMD_BYTES);
+    memset(input->yReversed + yLen, 0, SIMD_BYTES);
 }
 
 /**
- * erases the supplied Sequence array in address <sequences>.
- * @param sequences : array of type Sequence.
+ * frees the memory of <input>.
+ * @param input: the input of the anti diagonal kernels.
  */
-void eraseSequences(Sequence *const sequences)
+void freeDiagonalInput(DiagonalInput *const input)
 {
-    Sequence *curr = sequences,  *next;
-    while (curr != NULL)
-    {
-        next = getSeqNext(curr);
-        eraseSequence(curr);
-        curr = next;
-    }
+    free(input->x);
+    free(input->yReversed);
+    free(input->diagonals);
+}
+
+/**
+ * defines an anti diagonal kernel: the table is filled one anti diagonal (i + j = d) at a time,
+ * since every cell depends only on the two anti diagonals before it. the cells of an anti
+ * diagonal are calculated a vector at a time, indexed by their row i: cell (i, j) takes
+ * diagonal[d - 2][i - 1], diagonal[d - 1][i - 1] and diagonal[d - 1][i].
+ * the lanes that overrun the anti diagonal calculate garbage that is never read.
+ * @param NAME: the kernel's name.
+ * @param SCORE: the type of a score (int16_t or int32_t).
+ * @param BYTES: the size of the target's vector registers.
+ */
+#define DEFINE_DIAGONAL_KERNEL(NAME, SCORE, BYTES) \
+static inline __attribute__((always_inline)) \
+void NAME(const DiagonalInput *const input, const size_t xLen, const size_t yLen, const int m, \
+          const int s, const int g, int *const row) \
+{ \
+    typedef SCORE SCORES __attribute__((vector_size(BYTES))); \
+    typedef signed char CHARS __attribute__((vector_size(BYTES / sizeof(SCORE)))); \
+    const size_t lanes = sizeof(SCORES) / sizeof(SCORE); \
+    const SCORES matches = (SCORES){0} + (SCORE)m, misMatches = (SCORES){0} + (SCORE)s; \
+    const SCORES gaps = (SCORES){0} + (SCORE)g; \
+    SCORE *beforeLast = (SCORE *)input->diagonals; \
+    SCORE *last = beforeLast + input->stride, *curr = last + input->stride; \
+    size_t d, i; \
+    for (d = 0; d <= xLen + yLen; ++d) \
+    { \
+        const size_t first = (d > yLen) ? d - yLen : 1; \
+        const size_t end = (d <= xLen) ? d : xLen + 1; /* the cells with i < end and j > 0 */ \
+        for (i = first; i < end; i += lanes) \
+        { \
+            SCORES diagonal, above, left; \
+            CHARS xChars, yChars; \
+            memcpy(&diagonal, beforeLast + i - 1, sizeof(SCORES)); \
+            memcpy(&above, last + i - 1, sizeof(SCORES)); \
+            memcpy(&left, last + i, sizeof(SCORES)); \
+            memcpy(&xChars, input->x + i - 1, sizeof(CHARS)); \
+            memcpy(&yChars, input->yReversed + yLen - d + i, sizeof(CHARS)); \
+            const SCORES match = __builtin_convertvector(xChars == yChars, SCORES); \
+            SCORES score = diagonal + ((match & matches) | (~match & misMatches)); \
+            SCORES isAbove = (above > left); \
+            const SCORES gapScore = ((isAbove & above) | (~isAbove & left)) + gaps; \
+            isAbove = (gapScore > score); \
+            score = (isAbove & gapScore) | (~isAbove & score); \
+            memcpy(curr + i, &score, sizeof(SCORES)); \
+        } \
+        if (d <= yLen) /* the cell in the first row */ \
+        { \
+            curr[0] = (SCORE)((int)d * g); \
+        } \
+        if (d <= xLen) /* the cell in the first col */ \
+        { \
+            curr[d] = (SCORE)((int)d * g); \
+        } \
+        if (d >= xLen) /* the cell in the last row */ \
+        { \
+            row[d - xLen] = curr[xLen]; \
+        } \
+        SCORE *const oldest = beforeLast; \
+        beforeLast = last; \
+        last = curr; \
+        curr = oldest; \
+    } \
+}
+
+/**
+ * defines a LastRowKernel that is compiled for <TARGET>: the anti diagonal kernels are inlined
+ * into it, so their vectors are compiled to the target's instructions. tables whose scores fit
+ * in 16 bits are calculated in 16 bit lanes (twice the lanes), and others in 32 bit lanes.
+ * short sequences are left to the scalar kernel.
+ * @param NAME: the kernel's name.
+ * @param TARGET: the target attribute (empty for the default target).
+ * @param NARROW: the target's anti diagonal kernel of 16 bit scores.
+ * @param WIDE: the target's anti diagonal kernel of 32 bit scores.
+ */
+#define DEFINE_LAST_ROW_KERNEL(NAME, TARGET, NARROW, WIDE) \
+TARGET void NAME(const char *const x, const size_t xLen, const char *const y, \
+                 const size_t yLen, const int reverse, const int m, const int s, const int g, \
+                 int *const row) \
+{ \
+    if (xLen < MIN_SIMD_LEN || yLen < MIN_SIMD_LEN) \
+    { \
+        calLastRow(x, xLen, y, yLen, reverse, m, s, g, row); \
+        return; \
+    } \
+    DiagonalInput input; \
+    initDiagonalInput(&input, x, xLen, y, yLen, reverse, m, s, g); \
+    if (input.narrow) \
+    { \
+        NARROW(&input, xLen, yLen, m, s, g, row); \
+    } \
+    else \
+    { \
+        WIDE(&input, xLen, yLen, m, s, g, row); \
+    } \
+    freeDiagonalInput(&input); \
 }
 
+#if defined(__x86_64__) || defined(__i386__)
+DEFINE_DIAGONAL_KERNEL(calNarrowDiagonals128, int16_t, 16)
+DEFINE_DIAGONAL_KERNEL(calWideDiagonals128, int32_t, 16)
+DEFINE_DIAGONAL_KERNEL(calNarrowDiagonals256, int16_t, 32)
+DEFINE_DIAGONAL_KERNEL(calWideDiagonals256, int32_t, 32)
+DEFINE_DIAGONAL_KERNEL(calNarrowDiagonals512, int16_t, 64)
+DEFINE_DIAGONAL_KERNEL(calWideDiagonals512, int32_t, 64)
+DEFINE_LAST_ROW_KERNEL(calLastRowSse41, __attribute__((target("sse4.1"))), \
+                       calNarrowDiagonals128, calWideDiagonals128)
+DEFINE_LAST_ROW_KERNEL(calLastRowAvx2, __attribute__((target("avx2"))), \
+                       calNarrowDiagonals256, calWideDiagonals256)
+DEFINE_LAST_ROW_KERNEL(calLastRowAvx512, __attribute__((target("avx512f,avx512bw"))), \
+                       calNarrowDiagonals512, calWideDiagonals512)
+#elif defined(__ARM_NEON)
+DEFINE_DIAGONAL_KERNEL(calNarrowDiagonals128, int16_t, 16)
+DEFINE_DIAGONAL_KERNEL(calWideDiagonals128, int32_t, 16)
+DEFINE_LAST_ROW_KERNEL(calLastRowNeon, , calNarrowDiagonals128, calWideDiagonals128)
+#endif
+#endif
+
 /**
- * prints & frees the alignments
- * @param alignments : array of size <numOfAli>
- * @param numOfAli: len of <alignments>
+ * @param name: the name of a kernel (see the kernel option in the file description).
+ * @return the kernel called <name>, or NULL if it is unknown or the cpu doesn't support it.
  */
-void printAlignment(const size_t numOfAli, char **alignments)
+LastRowKernel selectKernel(const char *const name)
 {
-    size_t idx;
-    for (idx = 0; idx < numOfAli; ++idx)
+    const int isAuto = (strcmp(name, AUTO_KERNEL) == 0);
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    if ((isAuto || strcmp(name, "avx512") == 0) && __builtin_cpu_supports("avx512bw"))
+    {
+        return calLastRowAvx512;
+    }
+    if ((isAuto || strcmp(name, "avx2") == 0) && __builtin_cpu_supports("avx2"))
     {
-        printf("%s", alignments[idx]);
-        free(alignments[idx]);
+        return calLastRowAvx2;
     }
-    free(alignments);
+    if ((isAuto || strcmp(name, "sse4.1") == 0) && __builtin_cpu_supports("sse4.1"))
+    {
+        return calLastRowSse41;
+    }
+#elif defined(__GNUC__) && defined(__ARM_NEON)
+    if (isAuto || strcmp(name, "neon") == 0)
+    {
+        return calLastRowNeon;
+    }
+#endif
+    return (isAuto || strcmp(name, "scalar") == 0) ? calLastRow : NULL;
 }
 
 /**
- *computes & prints score and alignment for each couple of sequences we've read.
- * @param sequences: pointer to an array of Sequence objects.
- * @param m : match parameter
+ * aligns <x> and <y> by Hirschberg's algorithm: the optimal alignment path crosses the middle
+ * row of the table in the col that maximizes the sum of the scores of the table's upper half
+ * (from its start) and its lower half (from its end). both halves are aligned recursively, so
+ * only the two rows of size <yLen> + 1 are kept, and the time is still O(<xLen> * <yLen>).
+ * the alignment is written to <xAligned> and <yAligned> (without terminating '\0').
+ * @param x: the chars of the rows.
+ * @param xLen: the length of <x>.
+ * @param y: the chars of the cols.
+ * @param yLen: the length of <y>.
+ * @param m: match parameter
  * @param s : mismatch parameter
  * @param g : gap parameter
+ * @param forward: array of size (at least) <yLen> + 1.
+ * @param backward: array of size (at least) <yLen> + 1.
+ * @param xAligned: receives the aligned <x>.
+ * @param yAligned: receives the aligned <y>.
+ * @return the length of the alignment.
  */
-void calAndPrintScores(Sequence *sequences, const int m, const int s, const int g)
+size_t alignLinearSpace(const char *const x, const size_t xLen, const char *const y, \
+                        const size_t yLen, const int m, const int s, const int g, \
+                        int *const forward, int *const backward, char *const xAligned, \
+                        char *const yAligned)
 {
-    // calculate the alignments scores and prints them. keeps the alignments in an array.
-    char **alignments = NULL;
-    char * alignment = NULL;
-    size_t idx = 0;
-    Sequence *seq1 = sequences, *seq2;
-    while (getSeqNext(seq1) != NULL)
+    size_t i, j;
+    if (xLen == 0 || yLen == 0) // only gaps
     {
-        seq2 = getSeqNext(seq1);
-        while (seq2 != NULL)
+        for (i = 0; i < xLen; ++i)
         {
-            alignment = compareSequences(seq1, seq2, m, s, g);
-            alignments = (char **)realloc(alignments, sizeof(void *));
-            alignments[idx] = alignment;
-            seq2 = getSeqNext(seq2);
-            ++idx;
+            xAligned[i] = x[i];
+            yAligned[i] = SPACE_CHAR;
+        }
+        for (j = 0; j < yLen; ++j)
+        {
+            xAligned[j] = SPACE_CHAR;
+            yAligned[j] = y[j];
+        }
+        return xLen + yLen;
+    }
+    if (xLen == 1) // <x> is aligned to the (last) best char of <y>, or to no char at all
+    {
+        size_t best = 0;
+        for (j = 1; j < yLen; ++j)
+        {
+            if (calSubstitution(x[0], y[j], m, s) >= calSubstitution(x[0], y[best], m, s))
+            {
+                best = j;
+            }
+        }
+        if (calSubstitution(x[0], y[best], m, s) < 2 * g) // a gap in each is better
+        {
+            xAligned[0] = x[0];
+            yAligned[0] = SPACE_CHAR;
+            alignLinearSpace(x, 0, y, yLen, m, s, g, forward, backward, xAligned + 1, \
+                             yAligned + 1);
+            return yLen + 1;
+        }
+        for (j = 0; j < yLen; ++j)
+        {
+            xAligned[j] = (j == best) ? x[0] : SPACE_CHAR;
+            yAligned[j] = y[j];
+        }
+        return yLen;
+    }
+    const size_t mid = xLen / 2;
+    lastRowKernel(x, mid, y, yLen, 0, m, s, g, forward);
+    lastRowKernel(x + mid, xLen - mid, y, yLen, 1, m, s, g, backward);
+    size_t split = 0;
+    for (j = 1; j <= yLen; ++j)
+    {
+        if (forward[j] + backward[yLen - j] >= forward[split] + backward[yLen - split])
+        {
+            split = j;
+        }
+    }
+    const size_t upperLen = alignLinearSpace(x, mid, y, split, m, s, g, forward, backward, \
+                                             xAligned, yAligned);
+    return upperLen + alignLinearSpace(x + mid, xLen - mid, y + split, yLen - split, m, s, g, \
+                                       forward, backward, xAligned + upperLen, \
+                                       yAligned + upperLen);
+}
+
+/**
+ * calculates the alignment score of <seq1> and <seq2> without a table: a single rolling row of
+ * scores (see calLastRow) is kept for the shorter sequence, and nothing is traced back.
+ * @param seq1 : address of a sequence object.
+ * @param seq2 : address of a sequence object.
+ * @param m : match parameter
+ * @param s : mismatch parameter
+ * @param g : gap parameter
+ * @return the alignment score of <seq1> and <seq2>.
+ */
+int calScore(const Sequence *const seq1, const Sequence *const seq2, const int m, const int s,\
+             const int g)
+{
+    const size_t len1 = getSeqLen(seq1), len2 = getSeqLen(seq2);
+    const int swap = (len2 > len1); // the row of scores is kept for the shorter one
+    const size_t shorterLen = swap ? len1 : len2;
+    int *row = (int *)malloc((shorterLen + 1) * sizeof(int));
+    if (swap)
+    {
+        lastRowKernel(getSeqVal(seq2), len2, getSeqVal(seq1), len1, 0, m, s, g, row);
+    }
+    else
+    {
+        lastRowKernel(getSeqVal(seq1), len1, getSeqVal(seq2), len2, 0, m, s, g, row);
+    }
+    const int score = row[shorterLen];
+    free(row);
+    return score;
+}
+
+/**
+ * @param seq1Aligned: the aligned value of a sequence.
+ * @param seq2Aligned: the aligned value of a sequence.
+ * @param len: the length of the alignment.
+ * @param m: match parameter
+ * @param s : mismatch parameter
+ * @param g : gap parameter
+ * @return the score of the alignment.
+ */
+int calAlignmentScore(const char *const seq1Aligned, const char *const seq2Aligned, \
+                      const size_t len, const int m, const int s, const int g)
+{
+    int score = 0;
+    size_t idx;
+    for (idx = 0; idx < len; ++idx)
+    {
+        if (seq1Aligned[idx] == SPACE_CHAR || seq2Aligned[idx] == SPACE_CHAR)
+        {
+            score += g;
+        }
+        else
+        {
+            score += calSubstitution(seq1Aligned[idx], seq2Aligned[idx], m, s);
+        }
+    }
+    return score;
+}
+
+//------------------------Part 2 Logic: scoring schemes-------------------------------------------
+/**
+ * represents a scoring scheme: the score of aligning every couple of chars (<sub>, read from a
+ * substitution matrix file like BLOSUM62, see readMatrixFile), and affine gaps (Gotoh): a gap of
+ * length L scores <gapOpen> + L * <gapExtend>.
+ */
+typedef struct ScoringScheme
+{
+    int sub[UCHAR_MAX + 1][UCHAR_MAX + 1];
+    int gapOpen;
+    int gapExtend;
+}ScoringScheme;
+
+/**
+ * represents the query profile of a sequence y for a sequence x: for every char c of x, the row
+ * <rows>[c] keeps the scores of aligning c with every char of y (the rows of chars that aren't in
+ * x are NULL). so the inner loops look the score of a cell up, instead of comparing its chars.
+ * scores: the rows, one after the other.
+ */
+typedef struct Profile
+{
+    int *scores;
+    const int *rows[UCHAR_MAX + 1];
+}Profile;
+
+/**
+ * represents the last row of a table of affine gaps (see calProfileLastRow), of <yLen> + 1 cells:
+ * scores: the best score of the alignments that end in each cell.
+ * gapEnds: the best score of the alignments that end in each cell with a gap in y (i.e: a cell
+ *          above it).
+ * candidates: room for the scores of the cells before the gaps in x are considered.
+ */
+typedef struct AffineRows
+{
+    int *scores;
+    int *gapEnds;
+    int *candidates;
+}AffineRows;
+
+/**
+ * represents a kernel that calculates the last row of a table of affine gaps (see
+ * calProfileLastRow, which is the scalar kernel, for the parameters).
+ */
+typedef void (*ProfileKernel)(const char *const x, const size_t xLen, \
+                              const Profile *const profile, const size_t offset, \
+                              const size_t yLen, const int topOpen, \
+                              const ScoringScheme *const scheme, AffineRows *const rows);
+
+/**
+ * creates a scoring scheme of match/mismatch scores and affine gaps.
+ * @param m: match parameter
+ * @param s : mismatch parameter
+ * @param g : gap parameter (the score of each char of a gap)
+ * @param gapOpen : the score of opening a gap
+ * @return the scheme.
+ */
+ScoringScheme *createScoringScheme(const int m, const int s, const int g, const int gapOpen)
+{
+    ScoringScheme *scheme = (ScoringScheme *)malloc(sizeof(ScoringScheme));
+    assert(scheme != NULL);
+    size_t a, b;
+    for (a = 0; a <= UCHAR_MAX; ++a)
+    {
+        for (b = 0; b <= UCHAR_MAX; ++b)
+        {
+            scheme->sub[a][b] = (a == b) ? m : s;
+        }
+    }
+    scheme->gapOpen = gapOpen;
+    scheme->gapExtend = g;
+    return scheme;
+}
+
+/**
+ * reads a substitution matrix file into the <scheme>: lines that start with '#' are comments,
+ * the first other line lists the chars of the cols, and each line after it lists the char of a row
+ * followed by the scores of aligning it with the chars of the cols (as in NCBI's BLOSUM62).
+ * couples of chars that aren't in the matrix keep their match/mismatch scores. the matrix must be
+ * symmetric (as BLOSUM and PAM matrices are), since the sequences may be aligned either way.
+ * @param scheme: a scoring scheme.
+ * @param fileName: the name of the matrix file.
+ * @return 1 if the file is a valid matrix, else 0.
+ */
+int readMatrixFile(ScoringScheme *const scheme, const char *const fileName)
+{
+    FILE *file = fopen(fileName, "r");
+    if (file == NULL)
+    {
+        return 0;
+    }
+    unsigned char cols[UCHAR_MAX + 1];
+    size_t numOfCols = 0, numOfRows = 0, lineSize = 0;
+    char *line = NULL;
+    int isValid = 1;
+    while (isValid && getline(&line, &lineSize, file) != -1)
+    {
+        char *token = strtok(line, " \t\r\n");
+        if (token == NULL || token[0] == '#')
+        {
+            continue;
+        }
+        if (numOfCols == 0) // the chars of the cols
+        {
+            for (; token != NULL && isValid; token = strtok(NULL, " \t\r\n"))
+            {
+                isValid = (strlen(token) == 1 && numOfCols <= UCHAR_MAX);
+                cols[numOfCols++] = (unsigned char)token[0];
+            }
+            continue;
+        }
+        const unsigned char row = (unsigned char)token[0];
+        size_t col = 0;
+        isValid = (strlen(token) == 1);
+        for (token = strtok(NULL, " \t\r\n"); token != NULL && isValid; \
+             token = strtok(NULL, " \t\r\n"))
+        {
+            char *remaining = NULL;
+            const long score = strtol(token, &remaining, 10);
+            isValid = (col < numOfCols && *remaining == '\0');
+            if (isValid)
+            {
+                scheme->sub[row][cols[col++]] = (int)score;
+            }
+        }
+        isValid = isValid && (col == numOfCols);
+        ++numOfRows;
+    }
+    free(line);
+    fclose(file);
+    size_t a, b;
+    for (a = 0; a <= UCHAR_MAX && isValid; ++a)
+    {
+        for (b = 0; b < a && isValid; ++b)
+        {
+            isValid = (scheme->sub[a][b] == scheme->sub[b][a]);
+        }
+    }
+    return isValid && numOfRows > 0;
+}
+
+/**
+ * prepares the query profile of <y> for <x> (see Profile).
+ * @param profile: receives the profile (must be freed with freeProfile).
+ * @param x: the chars of the rows.
+ * @param xLen: the length of <x>.
+ * @param y: the chars of the cols.
+ * @param yLen: the length of <y>.
+ * @param reverse: 1 for the profile of the reversed <y>, else 0.
+ * @param scheme: the scoring scheme.
+ */
+void initProfile(Profile *const profile, const char *const x, const size_t xLen, \
+                 const char *const y, const size_t yLen, const int reverse, \
+                 const ScoringScheme *const scheme)
+{
+    size_t idx, j, numOfRows = 0;
+    int isInX[UCHAR_MAX + 1] = {0};
+    for (idx = 0; idx < xLen; ++idx)
+    {
+        numOfRows += !isInX[(unsigned char)x[idx]];
+        isInX[(unsigned char)x[idx]] = 1;
+    }
+    profile->scores = (int *)malloc((numOfRows * yLen + 1) * sizeof(int));
+    assert(profile->scores != NULL);
+    int *row = profile->scores;
+    for (idx = 0; idx <= UCHAR_MAX; ++idx)
+    {
+        profile->rows[idx] = NULL;
+        if (isInX[idx])
+        {
+            for (j = 0; j < yLen; ++j)
+            {
+                row[j] = scheme->sub[idx][(unsigned char)y[reverse ? yLen - 1 - j : j]];
+            }
+            profile->rows[idx] = row;
+            row += yLen;
+        }
+    }
+}
+
+/**
+ * frees the memory of <profile>.
+ * @param profile: a query profile.
+ */
+void freeProfile(Profile *const profile)
+{
+    free(profile->scores);
+}
+
+/**
+ * allocates affine rows of <yLen> + 1 cells.
+ * @param rows: receives the rows (must be freed with freeAffineRows).
+ * @param yLen: the length of the cols' sequence.
+ */
+void initAffineRows(AffineRows *const rows, const size_t yLen)
+{
+    rows->scores = (int *)malloc((yLen + 1) * sizeof(int));
+    rows->gapEnds = (int *)malloc((yLen + 1) * sizeof(int));
+    rows->candidates = (int *)malloc((yLen + 1) * sizeof(int));
+    assert(rows->scores != NULL && rows->gapEnds != NULL && rows->candidates != NULL);
+}
+
+/**
+ * frees the memory of <rows>.
+ * @param rows: affine rows.
+ */
+void freeAffineRows(AffineRows *const rows)
+{
+    free(rows->scores);
+    free(rows->gapEnds);
+    free(rows->candidates);
+}
+
+/**
+ * sets <rows> to the first row of a table of affine gaps.
+ * @param rows: affine rows of (at least) <yLen> + 1 cells.
+ * @param yLen: the length of the cols' sequence.
+ * @param scheme: the scoring scheme.
+ */
+void startAffineRows(AffineRows *const rows, const size_t yLen, const ScoringScheme *const scheme)
+{
+    size_t j;
+    rows->scores[0] = 0;
+    rows->gapEnds[0] = NO_SCORE;
+    for (j = 1; j <= yLen; ++j)
+    {
+        rows->scores[j] = scheme->gapOpen + (int)j * scheme->gapExtend;
+        rows->gapEnds[j] = NO_SCORE;
+    }
+}
+
+/**
+ * calculates the candidate score of the cell in col <j> of the next row, from the cells above it
+ * (the last row of <rows>): the best of the diagonal and the gaps in y. the gap in y is updated.
+ * @param rows: affine rows.
+ * @param sub: the scores of aligning the char of the next row with the chars of the cols.
+ * @param j: the col of the cell (> 0).
+ * @param gapOpen: the score of opening a gap
+ * @param gapExtend: the score of each char of a gap
+ */
+static inline void calProfileCandidate(AffineRows *const rows, const int *const sub, \
+                                       const size_t j, const int gapOpen, const int gapExtend)
+{
+    const int gapEnd = MAX(rows->gapEnds[j], rows->scores[j] + gapOpen) + gapExtend;
+    rows->gapEnds[j] = gapEnd;
+    rows->candidates[j] = MAX(rows->scores[j - 1] + sub[j - 1], gapEnd);
+}
+
+/**
+ * completes the row <i> of a table of affine gaps, once the candidates of its cells are known:
+ * the gaps in x depend on the cell to the left, so they are added from the first col to the last.
+ * a gap in x is opened after the candidate of the cell to the left rather than its score, which is
+ * the same as long as opening a gap doesn't score more than 0 (the cell's score is either its
+ * candidate, or a gap in x whose extension beats opening a new one), so the only dependency
+ * between the cells is the gap.
+ * @param rows: affine rows, with the candidates of row <i>.
+ * @param yLen: the length of the cols' sequence.
+ * @param i: the row (> 0).
+ * @param topOpen: the score of opening a gap in y at the first col (see calProfileLastRow).
+ * @param scheme: the scoring scheme.
+ */
+void endAffineRow(AffineRows *const rows, const size_t yLen, const size_t i, const int topOpen, \
+                  const ScoringScheme *const scheme)
+{
+    int *const scores = rows->scores, *const candidates = rows->candidates;
+    const int gapOpen = scheme->gapOpen, gapExtend = scheme->gapExtend;
+    scores[0] = rows->gapEnds[0] = candidates[0] = topOpen + (int)i * gapExtend;
+    int gapEnd = NO_SCORE;
+    size_t j;
+    for (j = 1; j <= yLen; ++j)
+    {
+        gapEnd = MAX(gapEnd, candidates[j - 1] + gapOpen) + gapExtend;
+        scores[j] = MAX(candidates[j], gapEnd);
+    }
+}
+
+/**
+ * calculates the last row of the table of affine gaps (Gotoh) of <x> (the rows) and <y> (the cols,
+ * given by its query profile), keeping a single row of each kind (see AffineRows). only the gaps
+ * in y that start at the first col score <topOpen> to open (0 if they continue a gap that was
+ * opened before the table), all other gaps score the scheme's gapOpen.
+ * @param x: the chars of the rows.
+ * @param xLen: the length of <x>.
+ * @param profile: the query profile of the cols' sequence for <x>.
+ * @param offset: the index in the profile of the first col.
+ * @param yLen: the num of cols.
+ * @param topOpen: the score of opening a gap in y at the first col.
+ * @param scheme: the scoring scheme.
+ * @param rows: affine rows of (at least) <yLen> + 1 cells, receive the last row.
+ */
+void calProfileLastRow(const char *const x, const size_t xLen, const Profile *const profile, \
+                       const size_t offset, const size_t yLen, const int topOpen, \
+                       const ScoringScheme *const scheme, AffineRows *const rows)
+{
+    size_t i, j;
+    startAffineRows(rows, yLen, scheme);
+    for (i = 1; i <= xLen; ++i)
+    {
+        const int *const sub = profile->rows[(unsigned char)x[i - 1]] + offset;
+        for (j = 1; j <= yLen; ++j)
+        {
+            calProfileCandidate(rows, sub, j, scheme->gapOpen, scheme->gapExtend);
+        }
+        endAffineRow(rows, yLen, i, topOpen, scheme);
+    }
+}
+
+/**
+ * the kernel that calculates the rows of affine gaps (see selectProfileKernel).
+ */
+static ProfileKernel profileKernel = calProfileLastRow;
+
+#if defined(__GNUC__)
+/**
+ * defines a ProfileKernel that is compiled for <TARGET>: the candidates of a row (see
+ * calProfileCandidate) depend only on the row above, so they are calculated a vector of cols at a
+ * time, and only the gaps in x are added one col at a time (see endAffineRow).
+ * @param NAME: the kernel's name.
+ * @param TARGET: the target attribute (empty for the default target).
+ * @param BYTES: the size of the target's vector registers.
+ */
+#define DEFINE_PROFILE_KERNEL(NAME, TARGET, BYTES) \
+TARGET void NAME(const char *const x, const size_t xLen, const Profile *const profile, \
+                 const size_t offset, const size_t yLen, const int topOpen, \
+                 const ScoringScheme *const scheme, AffineRows *const rows) \
+{ \
+    typedef int SCORES __attribute__((vector_size(BYTES))); \
+    const size_t lanes = sizeof(SCORES) / sizeof(int); \
+    const SCORES opens = (SCORES){0} + scheme->gapOpen; \
+    const SCORES extends = (SCORES){0} + scheme->gapExtend; \
+    size_t i, j; \
+    startAffineRows(rows, yLen, scheme); \
+    for (i = 1; i <= xLen; ++i) \
+    { \
+        const int *const sub = profile->rows[(unsigned char)x[i - 1]] + offset; \
+        for (j = 1; j + lanes <= yLen + 1; j += lanes) \
+        { \
+            SCORES above, diagonal, gapEnd, subs; \
+            memcpy(&above, rows->scores + j, sizeof(SCORES)); \
+            memcpy(&diagonal, rows->scores + j - 1, sizeof(SCORES)); \
+            memcpy(&gapEnd, rows->gapEnds + j, sizeof(SCORES)); \
+            memcpy(&subs, sub + j - 1, sizeof(SCORES)); \
+            above += opens; \
+            SCORES isMax = (gapEnd > above); \
+            gapEnd = ((isMax & gapEnd) | (~isMax & above)) + extends; \
+            diagonal += subs; \
+            isMax = (gapEnd > diagonal); \
+            diagonal = (isMax & gapEnd) | (~isMax & diagonal); \
+            memcpy(rows->gapEnds + j, &gapEnd, sizeof(SCORES)); \
+            memcpy(rows->candidates + j, &diagonal, sizeof(SCORES)); \
+        } \
+        for (; j <= yLen; ++j) /* the cols that don't fill a vector */ \
+        { \
+            calProfileCandidate(rows, sub, j, scheme->gapOpen, scheme->gapExtend); \
+        } \
+        endAffineRow(rows, yLen, i, topOpen, scheme); \
+    } \
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+DEFINE_PROFILE_KERNEL(calProfileLastRowSse41, __attribute__((target("sse4.1"))), 16)
+DEFINE_PROFILE_KERNEL(calProfileLastRowAvx2, __attribute__((target("avx2"))), 32)
+DEFINE_PROFILE_KERNEL(calProfileLastRowAvx512, __attribute__((target("avx512f,avx512bw"))), 64)
+#elif defined(__ARM_NEON)
+DEFINE_PROFILE_KERNEL(calProfileLastRowNeon, , 16)
+#endif
+#endif
+
+/**
+ * @param name: the name of a kernel (see the kernel option in the file description).
+ * @return the profile kernel called <name>, or NULL if it is unknown or the cpu doesn't support
+ *         it (see selectKernel).
+ */
+ProfileKernel selectProfileKernel(const char *const name)
+{
+    const int isAuto = (strcmp(name, AUTO_KERNEL) == 0);
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    if ((isAuto || strcmp(name, "avx512") == 0) && __builtin_cpu_supports("avx512bw"))
+    {
+        return calProfileLastRowAvx512;
+    }
+    if ((isAuto || strcmp(name, "avx2") == 0) && __builtin_cpu_supports("avx2"))
+    {
+        return calProfileLastRowAvx2;
+    }
+    if ((isAuto || strcmp(name, "sse4.1") == 0) && __builtin_cpu_supports("sse4.1"))
+    {
+        return calProfileLastRowSse41;
+    }
+#elif defined(__GNUC__) && defined(__ARM_NEON)
+    if (isAuto || strcmp(name, "neon") == 0)
+    {
+        return calProfileLastRowNeon;
+    }
+#endif
+    return (isAuto || strcmp(name, "scalar") == 0) ? calProfileLastRow : NULL;
+}
+
+/**
+ * represents the input of alignAffine: the sequences, the query profiles of the cols' sequence
+ * (and of its reverse) for the rows' sequence, and the rows of the upper and lower halves.
+ */
+typedef struct AffineInput
+{
+    const char *x;
+    char *xReversed;
+    size_t xLen;
+    const char *y;
+    size_t yLen;
+    Profile forward;
+    Profile backward;
+    AffineRows upper;
+    AffineRows lower;
+    const ScoringScheme *scheme;
+}AffineInput;
+
+/**
+ * @param scheme: the scoring scheme.
+ * @param len: the length of a gap.
+ * @return the score of a gap of length <len> (0 if there is no gap).
+ */
+int calGapScore(const ScoringScheme *const scheme, const size_t len)
+{
+    return (len == 0) ? 0 : scheme->gapOpen + (int)len * scheme->gapExtend;
+}
+
+/**
+ * writes <len> chars of <chars> aligned to gaps.
+ * @param chars: the chars.
+ * @param len: the num of chars.
+ * @param aligned: receives the chars.
+ * @param gaps: receives SPACE_CHAR for each char.
+ * @return the num of chars written.
+ */
+size_t writeGap(const char *const chars, const size_t len, char *const aligned, char *const gaps)
+{
+    memcpy(aligned, chars, len);
+    memset(gaps, SPACE_CHAR, len);
+    return len;
+}
+
+/**
+ * aligns x[<xStart>, <xStart> + <xLen>) and y[<yStart>, <yStart> + <yLen>) with affine gaps in
+ * linear space, by the algorithm of Myers and Miller: as in alignLinearSpace, the middle row of
+ * the table is crossed in the col that maximizes the sum of scores of the upper half (from its
+ * start) and the lower half (from its end). it is crossed either by a cell (where both halves
+ * meet), or by a gap in y that both halves end with (whose opening is counted once). the gaps in
+ * y that start at the first row score <topOpen> to open, and those that end at the last row
+ * <bottomOpen> (0 if they continue a gap out of the table), so the halves are aligned recursively.
+ * the alignment is written to <xAligned> and <yAligned> (without terminating '\0').
+ * @param input: the sequences (see AffineInput).
+ * @param xStart: the first row.
+ * @param xLen: the num of rows.
+ * @param yStart: the first col.
+ * @param yLen: the num of cols.
+ * @param topOpen: the score of opening a gap in y at the first row.
+ * @param bottomOpen: the score of opening a gap in y at the last row.
+ * @param xAligned: receives the aligned x.
+ * @param yAligned: receives the aligned y.
+ * @param len: receives the length of the alignment.
+ * @return the score of the alignment.
+ */
+int alignAffine(AffineInput *const input, const size_t xStart, const size_t xLen, \
+                const size_t yStart, const size_t yLen, const int topOpen, const int bottomOpen, \
+                char *const xAligned, char *const yAligned, size_t *const len)
+{
+    const ScoringScheme *const scheme = input->scheme;
+    const char *const x = input->x + xStart, *const y = input->y + yStart;
+    size_t j;
+    if (xLen == 0 || yLen == 0)
+    {
+        *len = writeGap(x, xLen, xAligned, yAligned) + writeGap(y, yLen, yAligned, xAligned);
+        return (xLen == 0) ? calGapScore(scheme, yLen) : \
+               MAX(topOpen, bottomOpen) + (int)xLen * scheme->gapExtend;
+    }
+    if (xLen == 1) // aligned to one of the chars of y, or to a gap (next to the better end)
+    {
+        int best = MAX(topOpen, bottomOpen) + scheme->gapExtend + calGapScore(scheme, yLen);
+        size_t bestJ = yLen;
+        for (j = 0; j < yLen; ++j)
+        {
+            const int score = calGapScore(scheme, j) + scheme->sub[(unsigned char)x[0]]\
+                              [(unsigned char)y[j]] + calGapScore(scheme, yLen - 1 - j);
+            if (score > best)
+            {
+                best = score, bestJ = j;
+            }
+        }
+        if (bestJ == yLen && topOpen >= bottomOpen)
+        {
+            *len = writeGap(x, 1, xAligned, yAligned);
+            *len += writeGap(y, yLen, yAligned + 1, xAligned + 1);
+        }
+        else if (bestJ == yLen)
+        {
+            *len = writeGap(y, yLen, yAligned, xAligned);
+            *len += writeGap(x, 1, xAligned + yLen, yAligned + yLen);
+        }
+        else
+        {
+            *len = writeGap(y, bestJ, yAligned, xAligned);
+            xAligned[bestJ] = x[0], yAligned[bestJ] = y[bestJ];
+            *len += 1 + writeGap(y + bestJ + 1, yLen - 1 - bestJ, yAligned + bestJ + 1, \
+                                 xAligned + bestJ + 1);
+        }
+        return best;
+    }
+    const size_t mid = xLen / 2;
+    AffineRows *const upper = &input->upper, *const lower = &input->lower;
+    profileKernel(x, mid, &input->forward, yStart, yLen, topOpen, scheme, upper);
+    profileKernel(input->xReversed + input->xLen - xStart - xLen, xLen - mid, &input->backward, \
+                  input->yLen - yStart - yLen, yLen, bottomOpen, scheme, lower);
+    int best = upper->scores[0] + lower->scores[yLen], isGap = 0;
+    size_t split = 0;
+    for (j = 0; j <= yLen; ++j)
+    {
+        const int byCell = upper->scores[j] + lower->scores[yLen - j];
+        const int byGap = upper->gapEnds[j] + lower->gapEnds[yLen - j] - scheme->gapOpen;
+        if (byCell > best)
+        {
+            best = byCell, split = j, isGap = 0;
+        }
+        if (byGap > best)
+        {
+            best = byGap, split = j, isGap = 1;
+        }
+    }
+    size_t upperLen, lowerLen;
+    if (isGap) // the gap ends the upper half at row mid - 1, and starts the lower one at row mid
+    {
+        alignAffine(input, xStart, mid - 1, yStart, split, topOpen, 0, xAligned, yAligned, \
+                    &upperLen);
+        upperLen += writeGap(x + mid - 1, 2, xAligned + upperLen, yAligned + upperLen);
+        alignAffine(input, xStart + mid + 1, xLen - mid - 1, yStart + split, yLen - split, 0, \
+                    bottomOpen, xAligned + upperLen, yAligned + upperLen, &lowerLen);
+    }
+    else
+    {
+        alignAffine(input, xStart, mid, yStart, split, topOpen, scheme->gapOpen, xAligned, \
+                    yAligned, &upperLen);
+        alignAffine(input, xStart + mid, xLen - mid, yStart + split, yLen - split, \
+                    scheme->gapOpen, bottomOpen, xAligned + upperLen, yAligned + upperLen, \
+                    &lowerLen);
+    }
+    *len = upperLen + lowerLen;
+    return best;
+}
+
+/**
+ * prepares the input of alignAffine (see AffineInput).
+ * @param input: receives the input (must be freed with freeAffineInput).
+ * @param x: the chars of the rows.
+ * @param xLen: the length of <x>.
+ * @param y: the chars of the cols.
+ * @param yLen: the length of <y>.
+ * @param scheme: the scoring scheme.
+ */
+void initAffineInput(AffineInput *const input, const char *const x, const size_t xLen, \
+                     const char *const y, const size_t yLen, const ScoringScheme *const scheme)
+{
+    size_t idx;
+    input->x = x;
+    input->xLen = xLen;
+    input->y = y;
+    input->yLen = yLen;
+    input->scheme = scheme;
+    input->xReversed = (char *)malloc(xLen + 1);
+    assert(input->xReversed != NULL);
+    for (idx = 0; idx < xLen; ++idx)
+    {
+        input->xReversed[idx] = x[xLen - 1 - idx];
+    }
+    initProfile(&input->forward, x, xLen, y, yLen, 0, scheme);
+    initProfile(&input->backward, x, xLen, y, yLen, 1, scheme);
+    initAffineRows(&input->upper, yLen);
+    initAffineRows(&input->lower, yLen);
+}
+
+/**
+ * frees the memory of <input>.
+ * @param input: the input of alignAffine.
+ */
+void freeAffineInput(AffineInput *const input)
+{
+    free(input->xReversed);
+    freeProfile(&input->forward);
+    freeProfile(&input->backward);
+    freeAffineRows(&input->upper);
+    freeAffineRows(&input->lower);
+}
+
+/**
+ * calculates the alignment score of <x> and <y> by the <scheme>, with a single row of each kind
+ * (see calProfileLastRow).
+ * @param x: the chars of the rows.
+ * @param xLen: the length of <x>.
+ * @param y: the chars of the cols.
+ * @param yLen: the length of <y>.
+ * @param scheme: the scoring scheme.
+ * @return the alignment score.
+ */
+int calSchemeScore(const char *const x, const size_t xLen, const char *const y, \
+                   const size_t yLen, const ScoringScheme *const scheme)
+{
+    Profile profile;
+    AffineRows rows;
+    initProfile(&profile, x, xLen, y, yLen, 0, scheme);
+    initAffineRows(&rows, yLen);
+    profileKernel(x, xLen, &profile, 0, yLen, scheme->gapOpen, scheme, &rows);
+    const int score = rows.scores[yLen];
+    freeProfile(&profile);
+    freeAffineRows(&rows);
+    return score;
+}
+
+//-----------------------Part 2 flow: sequences compare-------------------------------------------
+
+/**
+ * prints the alignment score for the sequences called <seq1Name>, <seq2Name>,
+ * in a specific syntax (see implementation).
+ * @param seq1Name: sequence object's name (address).
+ * @param seq2Name: sequence object's name (address).
+ * @param score: the alignment score for the sequences called <seq1Name>, <seq2Name>.
+ */
+void printScore(const char *const seq1Name, const char *const seq2Name, const int score)
+{
+    printf ("Score for alignment of %s to %s is %d\n", seq1Name, seq2Name, score);
+}
+
+/**
+ * prints that the sequences called <seq1Name>, <seq2Name> weren't aligned (see prefilterCouples),
+ * in the syntax of printScore.
+ * @param seq1Name: sequence object's name (address).
+ * @param seq2Name: sequence object's name (address).
+ */
+void printSkipped(const char *const seq1Name, const char *const seq2Name)
+{
+    printf ("Score for alignment of %s to %s is skipped\n", seq1Name, seq2Name);
+}
+
+/**
+ * writes the chars of the aligned params that the cell whose source is <sourceChar> adds, and moves
+ * <i>, <j> to the source cell.
+ * @param sourceChar: 'L', 'A' or 'D' (see Source).
+ * @param seq1Final: receives the char of the aligned param of seq1.
+ * @param seq2Final: receives the char of the aligned param of seq2.
+ * @param seq1Val: string representing the value field of a Sequence object
+ * @param seq2Val: string representing the value field of a Sequence object
+ * @param i: the index in <seq1Val> of the cell's row.
+ * @param j: the index in <seq2Val> of the cell's col.
+ */
+void analyzeSourceChar(const char sourceChar, char *const seq1Final, char *const seq2Final,\
+                       const char *const seq1Val, const char *const seq2Val, size_t *i, size_t *j)
+{
+    if (sourceChar == 'D')
+    {
+        *seq1Final = seq1Val[*i];
+        *seq2Final = seq2Val[*j];
+        --*i, --*j;
+    }
+    else if (sourceChar == 'L')
+    {
+        *seq1Final = SPACE_CHAR;
+        *seq2Final = seq2Val[*j];
+        --*j;
+    }
+    else if (sourceChar == 'A')
+    {
+        *seq1Final = seq1Val[*i];
+        *seq2Final = SPACE_CHAR;
+        --*i;
+    }
+}
+
+/**
+ * create a alignment from the 2 inputs (the alignment params)
+ * @param paramLen: the length of the 2 parameters
+ * @param seq1Aligned : the aligned param (not necessarily terminated)
+ * @param seq2Aligned: the aligned param (not necessarily terminated)
+ * @return the alignment (string of the form <seq1Aligned>\n<seq2Alignment>\n)
+ */
+char *createAlignment(const size_t paramLen, const char *const seq1Aligned, \
+                      const char *const seq2Aligned)
+{
+    char *alignment = (char *)malloc(sizeof(char) * (2 * paramLen + 3));
+    assert(alignment != NULL);
+    memcpy(alignment, seq1Aligned, paramLen);
+    alignment[paramLen] = '\n';
+    memcpy(alignment + paramLen + 1, seq2Aligned, paramLen);
+    alignment[2 * paramLen + 1] = '\n';
+    alignment[2 * paramLen + 2] = '\0';
+    return alignment;
+}
+   /**
+    * calculate the alignment for the sequences in a specific syntax (see implementation).
+    * the traceback runs from the last cell to the first, so the aligned params are written
+    * backwards, into buffers of the longest possible length (len of seq1 + len of seq2).
+    * @param seq1 : address of a sequence object.
+    * @param seq2 : address of a sequence object.
+    * @param traceback: a filled traceback (see fillTraceback) of <seq1> and <seq2>.
+    * @return the alignment.
+    */
+char *calAlignment(const Sequence *const seq1, const Sequence *const seq2,\
+                   const Traceback *const traceback)
+{
+    //initializes vars:
+    const size_t maxLen = getSeqLen(seq1) + getSeqLen(seq2);
+    char *seq1Aligned = (char *)malloc(maxLen);
+    char *seq2Aligned = (char *)malloc(maxLen);
+    assert(seq1Aligned != NULL && seq2Aligned != NULL);
+    size_t i = getSeqLen(seq1) - 1;
+    size_t j = getSeqLen(seq2) - 1;
+    const char *const seq1Val = getSeqVal(seq1);
+    const char *const seq2Val = getSeqVal(seq2);
+    size_t first = maxLen; // the aligned params so far are in [first, maxLen)
+
+    char sourceChar;
+    // the cell in [i + 1][j + 1] is the current one, and the cell in [0][0] has no source:
+    while ((sourceChar = getSourceChar(traceback, i + 1, j + 1)) != 0)
+    {
+        --first;
+        analyzeSourceChar(sourceChar, &seq1Aligned[first], &seq2Aligned[first], seq1Val, seq2Val, \
+                          &i, &j);
+    }
+    char *alignment = createAlignment(maxLen - first, seq1Aligned + first, seq2Aligned + first);
+    free(seq1Aligned);
+    free(seq2Aligned);
+    return alignment;
+}
+
+/**
+ * calculates the alignment score for the sequences <seq1>, <seq2> in linear space
+ * (see alignLinearSpace), and returns the alignment itself. the rows of scores are kept for
+ * the shorter sequence, so the memory is O(the shorter length) besides the alignment.
+ * @param seq1 : address of a sequence object.
+ * @param seq2 : address of a sequence object.
+ * @param m : match parameter
+ * @param s : mismatch parameter
+ * @param g : gap parameter
+ * @param score : receives the alignment score.
+ * @return the alignment (string of the form <seq1Aligned>\n<seq2Alignment>\n).
+ */
+char *compareSequencesLinearSpace(const Sequence *const seq1, const Sequence *const seq2,\
+                                  const int m, const int s, const int g, int *const score)
+{
+    const size_t len1 = getSeqLen(seq1), len2 = getSeqLen(seq2);
+    const int swap = (len2 > len1); // the rows of scores are kept for the shorter one
+    const size_t shorterLen = swap ? len1 : len2;
+    int *forward = (int *)malloc((shorterLen + 1) * sizeof(int));
+    int *backward = (int *)malloc((shorterLen + 1) * sizeof(int));
+    char *seq1Aligned = (char *)malloc(len1 + len2 + 1);
+    char *seq2Aligned = (char *)malloc(len1 + len2 + 1);
+    size_t len;
+    if (swap)
+    {
+        len = alignLinearSpace(getSeqVal(seq2), len2, getSeqVal(seq1), len1, m, s, g, forward,\
+                               backward, seq2Aligned, seq1Aligned);
+    }
+    else
+    {
+        len = alignLinearSpace(getSeqVal(seq1), len1, getSeqVal(seq2), len2, m, s, g, forward,\
+                               backward, seq1Aligned, seq2Aligned);
+    }
+    seq1Aligned[len] = seq2Aligned[len] = '\0';
+    free(forward);
+    free(backward);
+    *score = calAlignmentScore(seq1Aligned, seq2Aligned, len, m, s, g);
+    //creates alignment from the 2 aligned params, and frees their memory
+    char *alignment = createAlignment(len, seq1Aligned, seq2Aligned);
+    free(seq1Aligned);
+    free(seq2Aligned);
+    return alignment;
+}
+
+/**
+ * calculates the alignment score for the sequences <seq1>, <seq2> with banded tracebacks (see
+ * fillBandedTraceback), and returns the alignment itself. the band starts with a margin of
+ * INITIAL_BAND around the diagonals 0 and (len2 - len1), and its margin is doubled as long as the
+ * best score within it doesn't beat every alignment that leaves it (see calOutOfBandBound). once
+ * it does, the optimal alignment is within the band, and (since the ties are broken as in
+ * fillTraceback) it is the same alignment that the full table gives.
+ * @param seq1 : address of a sequence object.
+ * @param seq2 : address of a sequence object.
+ * @param m : match parameter
+ * @param s : mismatch parameter
+ * @param g : gap parameter
+ * @param score : receives the alignment score.
+ * @return the alignment, or NULL once the band is as wide as the table, or too big (see
+ *         MAX_TABLE_CELLS), without such a score.
+ */
+char *compareSequencesBanded(const Sequence *const seq1, const Sequence *const seq2,\
+                             const int m, const int s, const int g, int *const score)
+{
+    const size_t len1 = getSeqLen(seq1), len2 = getSeqLen(seq2);
+    const long diagonal = (long)len2 - (long)len1;
+    size_t k;
+    for (k = INITIAL_BAND; ; k *= 2)
+    {
+        const size_t width = (size_t)labs(diagonal) + 2 * k + 1;
+        if (width >= len2 + 1 || (double)(len1 + 1) * width > MAX_TABLE_CELLS)
+        {
+            return NULL;
+        }
+        Traceback *traceback = createBandedTraceback(len1 + 1, len2 + 1, \
+                                                     MIN(0, diagonal) - (long)k, width);
+        const int bandScore = fillBandedTraceback(traceback, seq1, seq2, m, s, g);
+        if (bandScore > calOutOfBandBound(len1, len2, k, m, s, g))
+        {
+            *score = bandScore;
+            char *alignment = calAlignment(seq1, seq2, traceback);
+            eraseTraceback(traceback);
+            return alignment;
+        }
+        eraseTraceback(traceback);
+    }
+}
+
+/**
+ * calculates the alignment score for the sequences <seq1>, <seq2> by the <scheme> (a substitution
+ * matrix and affine gaps), and returns the alignment itself, whatever the mode is, in linear space
+ * (see alignAffine). the query profile and the rows are kept for the shorter sequence.
+ * @param seq1 : address of a sequence object.
+ * @param seq2 : address of a sequence object.
+ * @param scheme : the scoring scheme.
+ * @param mode : the alignment mode (see AlignMode)
+ * @param score : receives the alignment score.
+ * @return the alignment (NULL in SCORE_ONLY mode).
+ */
+char *compareSequencesByScheme(const Sequence *const seq1, const Sequence *const seq2,\
+                               const ScoringScheme *const scheme, const AlignMode mode, \
+                               int *const score)
+{
+    const size_t len1 = getSeqLen(seq1), len2 = getSeqLen(seq2);
+    const int swap = (len2 > len1); // the rows of scores are kept for the shorter one
+    const char *const x = swap ? getSeqVal(seq2) : getSeqVal(seq1);
+    const char *const y = swap ? getSeqVal(seq1) : getSeqVal(seq2);
+    const size_t xLen = swap ? len2 : len1, yLen = swap ? len1 : len2;
+    if (mode == SCORE_ONLY)
+    {
+        *score = calSchemeScore(x, xLen, y, yLen, scheme);
+        return NULL;
+    }
+    AffineInput input;
+    initAffineInput(&input, x, xLen, y, yLen, scheme);
+    char *xAligned = (char *)malloc(len1 + len2 + 1);
+    char *yAligned = (char *)malloc(len1 + len2 + 1);
+    assert(xAligned != NULL && yAligned != NULL);
+    size_t len;
+    *score = alignAffine(&input, 0, xLen, 0, yLen, scheme->gapOpen, scheme->gapOpen, xAligned, \
+                         yAligned, &len);
+    freeAffineInput(&input);
+    char *alignment = swap ? createAlignment(len, yAligned, xAligned) : \
+                             createAlignment(len, xAligned, yAligned);
+    free(xAligned);
+    free(yAligned);
+    return alignment;
+}
+
+    /**
+     * calculates the alignment score for the sequences <seq1>, <seq2>, and returns the
+     * alignment itself. nothing is printed, so couples may be compared by several threads.
+     * @param seq1 : address of a sequence object.
+     * @param seq2 : address of a sequence object.
+     * @param m : match parameter
+     * @param s : mismatch parameter
+     * @param g : gap parameter
+     * @param mode : the alignment mode (see AlignMode)
+     * @param score : receives the alignment score.
+     * @return the alignment (NULL in SCORE_ONLY mode).
+     */
+char *compareSequences(const Sequence *const seq1, const Sequence *const seq2,\
+                       const int m, const int s, const int g, const AlignMode mode, \
+                       int *const score)
+{
+    const size_t rows = getSeqLen(seq1) + 1;
+    const size_t cols = getSeqLen(seq2) + 1;
+    if (mode == SCORE_ONLY)
+    {
+        *score = calScore(seq1, seq2, m, s, g);
+        return NULL;
+    }
+    if (mode == BANDED)
+    {
+        char *alignment = compareSequencesBanded(seq1, seq2, m, s, g, score);
+        if (alignment != NULL)
+        {
+            return alignment;
+        }
+    }
+    if (mode == LINEAR_SPACE || (double)rows * cols > MAX_TABLE_CELLS)
+    {
+        return compareSequencesLinearSpace(seq1, seq2, m, s, g, score);
+    }
+    Traceback *traceback = createTraceback(rows, cols);
+    *score = fillTraceback(traceback, seq1, seq2, m, s, g);
+    char *alignment = calAlignment(seq1, seq2, traceback);
+    eraseTraceback(traceback);
+    return alignment;
+}
+
+//------------------------Part 2 Flow: parallel couples--------------------------------------------
+/**
+ * represents a couple of sequences to compare (<seq1> precedes <seq2> in the file), and the
+ * results of the comparison: its <score> and <alignment>, which are valid once <done> is set.
+ * a <skipped> couple isn't compared at all (see prefilterCouples), after the num of distinct
+ * k-mers that its sequences share (<sharedKmers>) is counted.
+ */
+typedef struct Couple
+{
+    const Sequence *seq1;
+    const Sequence *seq2;
+    int score;
+    char *alignment;
+    int done;
+    size_t sharedKmers;
+    int skipped;
+}Couple;
+
+/**
+ * represents the couples [next, end) that are left to a worker. the owner takes them from the
+ * front, and idle workers steal half of them from the back.
+ */
+typedef struct CoupleRange
+{
+    size_t next;
+    size_t end;
+    pthread_mutex_t lock;
+}CoupleRange;
+
+/**
+ * represents the comparison of all the couples by a pool of <numOfThreads> workers, each starts
+ * with a contiguous range of (about) the same num of couples. since couples vary a lot in cost
+ * (len1 X len2), workers that run out of couples steal from the others (see takeCouple).
+ * the couples are scored by <m>, <s>, <g>, unless there is a <scheme> (see
+ * compareSequencesByScheme).
+ * <lock> guards the <done> fields of the couples, and <coupleDone> is signaled on every change.
+ */
+typedef struct CouplePool
+{
+    Couple *couples;
+    size_t numOfCouples;
+    CoupleRange *ranges;
+    size_t numOfThreads;
+    int m, s, g;
+    const ScoringScheme *scheme;
+    AlignMode mode;
+    pthread_mutex_t lock;
+    pthread_cond_t coupleDone;
+}CouplePool;
+
+/**
+ * represents a worker of a CouplePool: the pool and the index of its own range.
+ */
+typedef struct CoupleWorker
+{
+    CouplePool *pool;
+    size_t id;
+}CoupleWorker;
+
+/**
+ * takes the next couple of the worker's own range, or steals the back half of the range of
+ * another worker when its own range is empty.
+ * @param worker: the worker.
+ * @param couple: receives the index of the couple.
+ * @return 1 if a couple was taken, 0 if no couple is left.
+ */
+int takeCouple(CoupleWorker *const worker, size_t *const couple)
+{
+    CouplePool *const pool = worker->pool;
+    CoupleRange *const own = &pool->ranges[worker->id];
+    pthread_mutex_lock(&own->lock);
+    const int found = (own->next < own->end);
+    if (found)
+    {
+        *couple = own->next++;
+    }
+    pthread_mutex_unlock(&own->lock);
+    if (found)
+    {
+        return 1;
+    }
+    size_t i;
+    for (i = 1; i < pool->numOfThreads; ++i)
+    {
+        CoupleRange *const victim = &pool->ranges[(worker->id + i) % pool->numOfThreads];
+        size_t begin = 0, end = 0;
+        pthread_mutex_lock(&victim->lock);
+        if (victim->next < victim->end)
+        {
+            end = victim->end;
+            begin = victim->end - (victim->end - victim->next + 1) / 2;
+            victim->end = begin;
+        }
+        pthread_mutex_unlock(&victim->lock);
+        if (begin < end)
+        {
+            pthread_mutex_lock(&own->lock);
+            own->next = begin + 1;
+            own->end = end;
+            pthread_mutex_unlock(&own->lock);
+            *couple = begin;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * the body of every worker of a CouplePool: compares couples until none is left.
+ * @param arg: the CoupleWorker.
+ * @return NULL.
+ */
+void *coupleWorker(void *arg)
+{
+    CoupleWorker *const worker = (CoupleWorker *)arg;
+    CouplePool *const pool = worker->pool;
+    size_t idx;
+    while (takeCouple(worker, &idx))
+    {
+        Couple *const couple = &pool->couples[idx];
+        int score = 0;
+        char *alignment = couple->skipped ? NULL : (pool->scheme != NULL) ? \
+                          compareSequencesByScheme(couple->seq1, couple->seq2, pool->scheme, \
+                                                   pool->mode, &score) : \
+                          compareSequences(couple->seq1, couple->seq2, pool->m, pool->s, \
+                                           pool->g, pool->mode, &score);
+        pthread_mutex_lock(&pool->lock);
+        couple->score = score;
+        couple->alignment = alignment;
+        couple->done = 1;
+        pthread_cond_broadcast(&pool->coupleDone);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return NULL;
+}
+
+/**
+ * lists every couple of the supplied sequences, in the order of the file: (1, 2), (1, 3) ...
+ * (2, 3) ...
+ * @param sequences: the sequences (see SeqArena).
+ * @return the couples (an array of size seqNum * (seqNum - 1) / 2).
+ */
+Couple *listCouples(const SeqArena *const sequences)
+{
+    const size_t seqNum = sequences->seqNum;
+    Couple *couples = (Couple *)malloc(seqNum * (seqNum - 1) / 2 * sizeof(Couple));
+    assert(couples != NULL);
+    size_t idx = 0, seq1, seq2;
+    for (seq1 = 0; seq1 < seqNum; ++seq1)
+    {
+        for (seq2 = seq1 + 1; seq2 < seqNum; ++seq2)
+        {
+            couples[idx].seq1 = &sequences->seqs[seq1];
+            couples[idx].seq2 = &sequences->seqs[seq2];
+            couples[idx].alignment = NULL;
+            couples[idx].done = 0;
+            couples[idx].sharedKmers = 0;
+            couples[idx].skipped = 0;
+            ++idx;
+        }
+    }
+    return couples;
+}
+
+//------------------------Part 2 Flow: k-mer prefilter--------------------------------------------
+/**
+ * represents a distinct k-mer of the sequence of index <seq> (see hashKmers): its hash, and its
+ * residues (<len> chars in the sequence's value), which tell apart k-mers of the same hash.
+ */
+typedef struct KmerEntry
+{
+    uint64_t kmer;
+    const char *residues;
+    size_t len;
+    size_t seq;
+}KmerEntry;
+
+/**
+ * orders KmerEntries by their k-mer (its hash, and then its residues), and then by their
+ * sequence (for qsort).
+ */
+int compareKmerEntries(const void *a, const void *b)
+{
+    const KmerEntry *const x = (const KmerEntry *)a, *const y = (const KmerEntry *)b;
+    if (x->kmer != y->kmer)
+    {
+        return (x->kmer > y->kmer) - (x->kmer < y->kmer);
+    }
+    const int order = memcmp(x->residues, y->residues, x->len);
+    if (order != 0)
+    {
+        return order;
+    }
+    return (x->seq > y->seq) - (x->seq < y->seq);
+}
+
+/**
+ * @return whether the supplied KmerEntries hold the same k-mer (of any sequences).
+ */
+int isSameKmer(const KmerEntry *const x, const KmerEntry *const y)
+{
+    return x->kmer == y->kmer && memcmp(x->residues, y->residues, x->len) == 0;
+}
+
+/**
+ * hashes every k-mer (substring of len <k>) of <val> by a rolling polynomial hash, and keeps the
+ * distinct ones. k-mers of the same hash are told apart by their residues, so a collision
+ * changes neither the num of distinct k-mers nor the ones a couple shares.
+ * @param val: the value of the sequence.
+ * @param len: the len of <val>.
+ * @param k: the len of the k-mers.
+ * @param seq: the index of the sequence.
+ * @param entries: receives the k-mers (an array of size len - k + 1 at least).
+ * @return the num of distinct k-mers (0 when <val> is shorter than <k>).
+ */
+size_t hashKmers(const char *const val, const size_t len, const size_t k, const size_t seq, \
+                 KmerEntry *const entries)
+{
+    if (len < k)
+    {
+        return 0;
+    }
+    uint64_t power = 1, hash = 0; // power = base ^ k, drops the char that leaves the window
+    size_t i, num = 0;
+    for (i = 0; i < k; ++i)
+    {
+        power *= KMER_HASH_BASE;
+    }
+    for (i = 0; i < len; ++i)
+    {
+        hash = hash * KMER_HASH_BASE + (unsigned char)val[i];
+        if (i >= k)
+        {
+            hash -= power * (unsigned char)val[i - k];
+        }
+        if (i + 1 >= k)
+        {
+            entries[num].kmer = hash;
+            entries[num].residues = val + i + 1 - k;
+            entries[num].len = k;
+            entries[num++].seq = seq;
+        }
+    }
+    qsort(entries, num, sizeof(KmerEntry), compareKmerEntries);
+    size_t distinct = 1;
+    for (i = 1; i < num; ++i)
+    {
+        if (!isSameKmer(&entries[i], &entries[distinct - 1]))
+        {
+            entries[distinct++] = entries[i];
+        }
+    }
+    return distinct;
+}
+
+/**
+ * skips the couples whose sequences share less than <minKmers> distinct k-mers of len <k>,
+ * since unrelated sequences share (almost) none. the k-mers of all the sequences are indexed
+ * once, sorted by k-mer, so every k-mer adds one to each couple of the sequences that have it,
+ * and the work is about linear in the num of residues rather than in their product (only
+ * k-mers that are common to many sequences add more).
+ * @param couples: the couples (see listCouples).
+ * @param sequences: the sequences (see SeqArena).
+ * @param k: the len of the k-mers.
+ * @param minKmers: the minimal num of shared k-mers of a couple to compare.
+ */
+void prefilterCouples(Couple *const couples, const SeqArena *const sequences, const size_t k, \
+                      const size_t minKmers)
+{
+    const size_t seqNum = sequences->seqNum;
+    size_t seq, numOfEntries = 0;
+    for (seq = 0; seq < seqNum; ++seq)
+    {
+        numOfEntries += getSeqLen(&sequences->seqs[seq]);
+    }
+    KmerEntry *entries = (KmerEntry *)malloc((numOfEntries + 1) * sizeof(KmerEntry));
+    assert(entries != NULL);
+    numOfEntries = 0;
+    for (seq = 0; seq < seqNum; ++seq)
+    {
+        numOfEntries += hashKmers(getSeqVal(&sequences->seqs[seq]), \
+                                  getSeqLen(&sequences->seqs[seq]), k, seq, \
+                                  entries + numOfEntries);
+    }
+    qsort(entries, numOfEntries, sizeof(KmerEntry), compareKmerEntries);
+    size_t first, last;
+    for (first = 0; first < numOfEntries; first = last)
+    {
+        for (last = first + 1; last < numOfEntries && isSameKmer(&entries[last], &entries[first]);)
+        {
+            ++last;
+        }
+        size_t a, b;
+        for (a = first; a < last; ++a)
+        {
+            const size_t seq1 = entries[a].seq;
+            const size_t row = seq1 * seqNum - seq1 * (seq1 + 1) / 2 - seq1 - 1; // see listCouples
+            for (b = a + 1; b < last; ++b)
+            {
+                ++couples[row + entries[b].seq].sharedKmers;
+            }
+        }
+    }
+    free(entries);
+    const size_t numOfCouples = seqNum * (seqNum - 1) / 2;
+    size_t idx;
+    for (idx = 0; idx < numOfCouples; ++idx)
+    {
+        couples[idx].skipped = (couples[idx].sharedKmers < minKmers);
+    }
+}
+
+//----------------------------Running the program--------------------------------------------------
+/**
+ * @param str some string
+ * @param isInteger
+ * @return the converted int that str represents (no change to isInteger).
+ * if str doesn't represents int, isInteger will be 0.
+ */
+long stringToInt(const char *const str, size_t *const isInteger)
+{
+    char *remaining = NULL;
+    long result = strtol(str, &remaining, 10);
+    if (strcmp(remaining, "") != 0)
+    {
+        *isInteger = 0;
+    }
+    return result;
+}
+
+/**
+ *computes & prints score and alignment for each couple of sequences we've read. the couples are
+ * compared by a pool of threads (see CouplePool), and the scores are printed in the order of the
+ * couples as soon as they are known, followed by the alignments in the same order.
+ * @param sequences: the sequences (see SeqArena).
+ * @param m : match parameter
+ * @param s : mismatch parameter
+ * @param g : gap parameter
+ * @param scheme : the scoring scheme, or NULL to score by <m>, <s>, <g> alone.
+ * @param mode : the alignment mode (see AlignMode)
+ * @param numOfThreads : the maximal num of threads to compare the couples.
+ * @param k : the len of the k-mers of the prefilter (see prefilterCouples), or 0 to compare all
+ *            the couples.
+ * @param minKmers : the minimal num of shared k-mers of a couple to compare.
+ */
+void calAndPrintScores(const SeqArena *const sequences, const int m, const int s, const int g, \
+                       const ScoringScheme *const scheme, const AlignMode mode, \
+                       const size_t numOfThreads, const size_t k, const size_t minKmers)
+{
+    CouplePool pool;
+    pool.numOfCouples = sequences->seqNum * (sequences->seqNum - 1) / 2;
+    pool.couples = listCouples(sequences);
+    if (k > 0)
+    {
+        prefilterCouples(pool.couples, sequences, k, minKmers);
+    }
+    pool.numOfThreads = MIN(numOfThreads, pool.numOfCouples);
+    pool.m = m, pool.s = s, pool.g = g;
+    pool.scheme = scheme;
+    pool.mode = mode;
+    pool.ranges = (CoupleRange *)malloc(pool.numOfThreads * sizeof(CoupleRange));
+    CoupleWorker *workers = (CoupleWorker *)malloc(pool.numOfThreads * sizeof(CoupleWorker));
+    pthread_t *threads = (pthread_t *)malloc(pool.numOfThreads * sizeof(pthread_t));
+    assert(pool.ranges != NULL && workers != NULL && threads != NULL);
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.coupleDone, NULL);
+    size_t idx, numOfStarted = 0;
+    for (idx = 0; idx < pool.numOfThreads; ++idx)
+    {
+        pool.ranges[idx].next = pool.numOfCouples * idx / pool.numOfThreads;
+        pool.ranges[idx].end = pool.numOfCouples * (idx + 1) / pool.numOfThreads;
+        pthread_mutex_init(&pool.ranges[idx].lock, NULL);
+        workers[idx].pool = &pool;
+        workers[idx].id = idx;
+    }
+    if (pool.numOfThreads > 1)
+    {
+        while (numOfStarted < pool.numOfThreads && pthread_create(&threads[numOfStarted], NULL, \
+                                                   coupleWorker, &workers[numOfStarted]) == 0)
+        {
+            ++numOfStarted;
+        }
+    }
+    if (numOfStarted == 0) // a single thread, or threads are unavailable: compares them here
+    {
+        coupleWorker(&workers[0]);
+    }
+    // prints the scores in order, each as soon as its couple is done:
+    pthread_mutex_lock(&pool.lock);
+    for (idx = 0; idx < pool.numOfCouples; ++idx)
+    {
+        while (!pool.couples[idx].done)
+        {
+            pthread_cond_wait(&pool.coupleDone, &pool.lock);
+        }
+        if (pool.couples[idx].skipped)
+        {
+            printSkipped(getSeqName(pool.couples[idx].seq1), getSeqName(pool.couples[idx].seq2));
+        }
+        else
+        {
+            printScore(getSeqName(pool.couples[idx].seq1), getSeqName(pool.couples[idx].seq2), \
+                       pool.couples[idx].score);
         }
-        seq1 = getSeqNext(seq1);
+    }
+    pthread_mutex_unlock(&pool.lock);
+    for (idx = 0; idx < numOfStarted; ++idx)
+    {
+        pthread_join(threads[idx], NULL);
     }
     // prints & frees the alignments:
-    printAlignment(idx, alignments);
+    for (idx = 0; idx < pool.numOfCouples; ++idx)
+    {
+        if (pool.couples[idx].alignment != NULL)
+        {
+            printf("%s", pool.couples[idx].alignment);
+            free(pool.couples[idx].alignment);
+        }
+    }
+    for (idx = 0; idx < pool.numOfThreads; ++idx)
+    {
+        pthread_mutex_destroy(&pool.ranges[idx].lock);
+    }
+    pthread_mutex_destroy(&pool.lock);
+    pthread_cond_destroy(&pool.coupleDone);
+    free(pool.couples);
+    free(pool.ranges);
+    free(workers);
+    free(threads);
 }
 /**
  * runs the program (see in file description).
@@ -719,29 +2412,127 @@ void calAndPrintScores(Sequence *sequences, const int m, const int s, const int
  */
 int main(const int argc, const char *argv[])
 {
-    if (argc == 5)
+    // the options precede the arguments:
+    AlignMode mode = FULL_TABLE;
+    lastRowKernel = selectKernel(AUTO_KERNEL);
+    profileKernel = selectProfileKernel(AUTO_KERNEL);
+    const char *matrixFileName = NULL;
+    long gapOpen = 0;
+    size_t kmerLen = 0, minKmers = DEFAULT_MIN_KMERS;
+    const long numOfCores = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t numOfThreads = (numOfCores > 0) ? (size_t)numOfCores : 1;
+    int first = 1;
+    while (first < argc && strncmp(argv[first], OPTION_PREFIX, strlen(OPTION_PREFIX)) == 0)
+    {
+        if (strcmp(argv[first], LINEAR_SPACE_OPTION) == 0 && mode != SCORE_ONLY)
+        {
+            mode = LINEAR_SPACE;
+        }
+        else if (strcmp(argv[first], BANDED_OPTION) == 0 && mode != SCORE_ONLY)
+        {
+            mode = BANDED;
+        }
+        else if (strcmp(argv[first], SCORE_ONLY_OPTION) == 0)
+        {
+            mode = SCORE_ONLY;
+        }
+        else if (strncmp(argv[first], KERNEL_OPTION, strlen(KERNEL_OPTION)) == 0)
+        {
+            lastRowKernel = selectKernel(argv[first] + strlen(KERNEL_OPTION));
+            profileKernel = selectProfileKernel(argv[first] + strlen(KERNEL_OPTION));
+            if (lastRowKernel == NULL || profileKernel == NULL)
+            {
+                USAGE_ERR_MSG;
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (strncmp(argv[first], THREADS_OPTION, strlen(THREADS_OPTION)) == 0)
+        {
+            size_t isInteger = 1;
+            const long threads = stringToInt(argv[first] + strlen(THREADS_OPTION), &isInteger);
+            if (!isInteger || threads <= 0)
+            {
+                USAGE_ERR_MSG;
+                exit(EXIT_FAILURE);
+            }
+            numOfThreads = (size_t)threads;
+        }
+        else if (strncmp(argv[first], MATRIX_OPTION, strlen(MATRIX_OPTION)) == 0)
+        {
+            matrixFileName = argv[first] + strlen(MATRIX_OPTION);
+        }
+        else if (strncmp(argv[first], GAP_OPEN_OPTION, strlen(GAP_OPEN_OPTION)) == 0)
+        {
+            size_t isInteger = 1;
+            gapOpen = stringToInt(argv[first] + strlen(GAP_OPEN_OPTION), &isInteger);
+            if (!isInteger || gapOpen > 0)
+            {
+                USAGE_ERR_MSG;
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (strncmp(argv[first], KMER_OPTION, strlen(KMER_OPTION)) == 0 || \
+                 strncmp(argv[first], MIN_KMERS_OPTION, strlen(MIN_KMERS_OPTION)) == 0)
+        {
+            const int isKmer = (strncmp(argv[first], KMER_OPTION, strlen(KMER_OPTION)) == 0);
+            size_t isInteger = 1;
+            const long value = stringToInt(argv[first] + (isKmer ? strlen(KMER_OPTION) : \
+                                                          strlen(MIN_KMERS_OPTION)), &isInteger);
+            if (!isInteger || value <= 0)
+            {
+                USAGE_ERR_MSG;
+                exit(EXIT_FAILURE);
+            }
+            *(isKmer ? &kmerLen : &minKmers) = (size_t)value;
+        }
+        else if (strcmp(argv[first], LINEAR_SPACE_OPTION) != 0 && \
+                 strcmp(argv[first], BANDED_OPTION) != 0)
+        {
+            USAGE_ERR_MSG;
+            exit(EXIT_FAILURE);
+        }
+        ++first;
+    }
+    if (argc - first == NUM_OF_ARGS)
     {
-        const char *const fileName = argv[1];
-        FILE *file = fopen(fileName, "r");
-        if (file != NULL)
+        const char *const fileName = argv[first];
+        const int file = open(fileName, O_RDONLY);
+        if (file >= 0)
         {
             size_t isInteger = 1;
             // get parameters m, s, g :
-            int match = (int)stringToInt(argv[2], &isInteger);
-            int misMatch = (int)stringToInt(argv[3], &isInteger);
-            int gap = (int)stringToInt(argv[4], &isInteger);
+            int match = (int)stringToInt(argv[first + 1], &isInteger);
+            int misMatch = (int)stringToInt(argv[first + 2], &isInteger);
+            int gap = (int)stringToInt(argv[first + 3], &isInteger);
             if (isInteger) //assert they are ints
             {
-                size_t seqNum = 0;
-                Sequence *const sequences = parseSeqFile(file, &seqNum); //part1
-                if (seqNum < 2)
+                SeqArena *const sequences = parseSeqFile(file); //part1
+                close(file);
+                if (sequences == NULL)
+                {
+                    USAGE_ERR_MSG;
+                    exit(EXIT_FAILURE);
+                }
+                if (sequences->seqNum < 2)
                 {
                     SEQ_NUM_ERR_MSG(fileName);
                     exit(EXIT_FAILURE);
                 }
-                calAndPrintScores(sequences, match, misMatch, gap); //part2
-                eraseSequences(sequences);
-                fclose(file);
+                // a scoring scheme only when the scores aren't just match/mismatch/linear gaps:
+                ScoringScheme *scheme = NULL;
+                if (matrixFileName != NULL || gapOpen != 0)
+                {
+                    scheme = createScoringScheme(match, misMatch, gap, (int)gapOpen);
+                    if (matrixFileName != NULL && !readMatrixFile(scheme, matrixFileName))
+                    {
+                        MATRIX_ERR_MSG(matrixFileName);
+                        exit(EXIT_FAILURE);
+                    }
+                }
+                calAndPrintScores(sequences, match, misMatch, gap, scheme, mode, \
+                                  numOfThreads, kmerLen, minKmers); //part2
+                free(scheme);
+                eraseSeqArena(sequences);
                 return 0;
             }
         }
@@ -0,0 +1,136 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <assert.h>
+
+/**
+ * allocates a new, empty, chunk.
+ * @param capacity : the num of bytes of the chunk.
+ * @param prev : the chunk that was allocated before it.
+ * @return : the chunk, or NULL if the memory allocation failed.
+ */
+static ArenaChunk* chunkAlloc(size_t capacity, ArenaChunk* prev)
+{
+    ArenaChunk* chunk = (ArenaChunk*)malloc(sizeof(ArenaChunk) + capacity);
+    if (chunk == NULL)
+    {
+        fprintf(stderr, "%s", MEM_SEG_ERR);
+        return NULL;
+    }
+    chunk->_prev = prev;
+    chunk->_capacity = capacity;
+    chunk->_used = 0;
+    return chunk;
+}
+
+/**
+ * @param chunk : a chunk of an Arena.
+ * @return : the num of bytes to skip, so the next block of <chunk> is aligned to ARENA_ALIGNMENT.
+ */
+static size_t alignmentPadding(const ArenaChunk* chunk)
+{
+    const uintptr_t next = (uintptr_t)(chunk->_data + chunk->_used);
+    return (ARENA_ALIGNMENT - next % ARENA_ALIGNMENT) % ARENA_ALIGNMENT;
+}
+
+/**
+ * creates a new Arena object
+ * @return : the arena, or NULL if the memory allocation failed.
+ */
+Arena* arenaAlloc()
+{
+    Arena* arena = (Arena*)malloc(sizeof(Arena));
+    if (arena != NULL)
+    {
+        arena->_top = chunkAlloc(ARENA_INITIAL_CAPACITY, NULL);
+        if (arena->_top != NULL)
+        {
+            arena->_total = ARENA_INITIAL_CAPACITY;
+            return arena;
+        }
+        free(arena);
+        return NULL;
+    }
+    fprintf(stderr, "%s", MEM_SEG_ERR);
+    return NULL;
+}
+
+/**
+ * allocates a block from the arena.
+ * @param arena : an Arena object
+ * @param size : the num of bytes of the block.
+ * @return : the address of the block (aligned to ARENA_ALIGNMENT), or NULL if the memory
+ *           allocation failed.
+ */
+void* arenaMalloc(Arena* arena, size_t size)
+{
+    assert(arena != NULL);
+    size_t padding = alignmentPadding(arena->_top);
+    if (arena->_top->_capacity - arena->_top->_used < padding + size)
+    {
+        size_t capacity = 2 * arena->_top->_capacity;
+        while (capacity < size + ARENA_ALIGNMENT)
+        {
+            capacity *= 2;
+        }
+        ArenaChunk* chunk = chunkAlloc(capacity, arena->_top);
+        if (chunk == NULL)
+        {
+            return NULL;
+        }
+        arena->_top = chunk;
+        arena->_total += capacity;
+        padding = alignmentPadding(chunk);
+    }
+    void* block = arena->_top->_data + arena->_top->_used + padding;
+    arena->_top->_used += padding + size;
+    return block;
+}
+
+/**
+ * frees all the blocks of the arena at once. the chunks are merged into a single one that holds
+ * all of them, so an arena that is reset after every expression stops allocating memory once it
+ * is big enough for the largest of them.
+ * @param arena : an Arena object
+ */
+void arenaReset(Arena* arena)
+{
+    assert(arena != NULL);
+    if (arena->_top->_prev != NULL)
+    {
+        ArenaChunk* chunk = arena->_top;
+        while (chunk != NULL)
+        {
+            ArenaChunk* prev = chunk->_prev;
+            free(chunk);
+            chunk = prev;
+        }
+        arena->_top = chunkAlloc(arena->_total, NULL);
+        if (arena->_top == NULL)
+        {
+            exit(EXIT_FAILURE);
+        }
+    }
+    arena->_top->_used = 0;
+}
+
+/**
+ * deletes the arena & frees the memory
+ * @param arena: the address of an Arena object
+ */
+void freeArena(Arena** arena)
+{
+    if (*arena != NULL)
+    {
+        ArenaChunk* chunk = (*arena)->_top;
+        while (chunk != NULL)
+        {
+            ArenaChunk* prev = chunk->_prev;
+            free(chunk);
+            chunk = prev;
+        }
+        free(*arena);
+        *arena = NULL;
+    }
+}
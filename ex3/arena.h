@@ -0,0 +1,74 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#define MEM_SEG_ERR "Error in memory allocation.\n"
+
+/**
+ * the num of bytes of the first chunk of a new Arena.
+ */
+#define ARENA_INITIAL_CAPACITY 4096
+
+/**
+ * the alignment of every block that an Arena allocates.
+ */
+#define ARENA_ALIGNMENT 16
+
+/**
+ * represents a chunk of an Arena with the fields:
+ * prev: the address of the chunk that was allocated before this one (NULL for the first).
+ * capacity: the num of bytes in data.
+ * used: the num of bytes of data that were allocated.
+ * data: the bytes of the chunk.
+ */
+typedef struct ArenaChunk
+{
+  struct ArenaChunk * _prev;
+  size_t _capacity;
+  size_t _used;
+  char _data[];
+} ArenaChunk;
+
+/**
+ * represents an Arena (a bump allocator) with the fields:
+ * top: address of the chunk that blocks are allocated from. when it is full a bigger chunk is
+ *      added, so the blocks that were allocated never move.
+ * total: the num of bytes in all of the chunks.
+ * all the blocks are freed at once, by resetting the arena (see arenaReset).
+ */
+typedef struct Arena
+{
+  ArenaChunk * _top;
+  size_t _total;
+} Arena;
+
+/**
+ * creates a new Arena object
+ * @return : the arena, or NULL if the memory allocation failed.
+ */
+Arena* arenaAlloc();
+
+/**
+ * allocates a block from the arena.
+ * @param arena : an Arena object
+ * @param size : the num of bytes of the block.
+ * @return : the address of the block (aligned to ARENA_ALIGNMENT), or NULL if the memory
+ *           allocation failed.
+ */
+void* arenaMalloc(Arena* arena, size_t size);
+
+/**
+ * frees all the blocks of the arena at once. the chunks are merged into a single one that holds
+ * all of them, so an arena that is reset after every expression stops allocating memory once it
+ * is big enough for the largest of them.
+ * @param arena : an Arena object
+ */
+void arenaReset(Arena* arena);
+
+/**
+ * deletes the arena & frees the memory
+ * @param arena: the address of an Arena object
+ */
+void freeArena(Arena** arena);
+
+#endif //ARENA_H
@@ -0,0 +1,449 @@
+//-------------------INCLUDES----------------------------------------------------------------------
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "arena.h"
+#include "token.h"
+#include "stack.h"
+#include "program.h"
+
+//----------------CONSTANTS------------------------------------------------------------------------
+/**
+ * the num of pushes (pops, peeks) that every stack benchmark times.
+ */
+#define STACK_OPS (1 << 22)
+
+/**
+ * the element sizes of the stack benchmarks (in bytes).
+ */
+static const size_t ELEMENT_SIZES[] = {1, 4, 8, 16, 64};
+
+/**
+ * the num of expressions of every corpus, and the nesting depths of the corpora.
+ */
+#define CORPUS_LEN (1 << 15)
+static const size_t CORPUS_DEPTHS[] = {1, 4, 16, 64, 128};
+
+/**
+ * the seed of the generator of the corpora, so every run times the same expressions.
+ */
+#define CORPUS_SEED 2463534242u
+
+#define NUM_OF(array) (sizeof(array) / sizeof((array)[0]))
+
+//------------------------THE PHASES OF CALC (main.c)----------------------------------------------
+
+Token **expToInfix(Arena *arena, const char *exp, const size_t expLen, size_t *size);
+Token **infixToPostfix(Arena *arena, const char *line, Token **infix, const size_t inSize, \
+                       Stack *operators, size_t *const size);
+
+//------------------------ALLOCATION COUNTERS------------------------------------------------------
+
+/**
+ * the num of calls to the allocator since the counters were reset (see resetCounters). the
+ * benchmark is linked with -Wl,--wrap of malloc, calloc, realloc & free, so every object file
+ * (and libstack.a) calls the wrappers below instead of the allocator.
+ * (allocations inside the C library itself, e.g. of open_memstream, aren't counted).
+ */
+typedef struct Counters
+{
+    size_t _mallocs;
+    size_t _reallocs;
+    size_t _frees;
+}Counters;
+
+static Counters counters;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t num, size_t size);
+void *__real_realloc(void *block, size_t size);
+void __real_free(void *block);
+
+void *__wrap_malloc(size_t size)
+{
+    ++counters._mallocs;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t num, size_t size)
+{
+    ++counters._mallocs;
+    return __real_calloc(num, size);
+}
+
+/**
+ * a realloc of NULL is counted as a malloc, a realloc to 0 bytes as a free, and any other one
+ * (that grows or shrinks a block, and may move it) as a realloc.
+ */
+void *__wrap_realloc(void *block, size_t size)
+{
+    counters._mallocs += (block == NULL);
+    counters._reallocs += (block != NULL && size != 0);
+    counters._frees += (block != NULL && size == 0);
+    return __real_realloc(block, size);
+}
+
+void __wrap_free(void *block)
+{
+    counters._frees += (block != NULL);
+    __real_free(block);
+}
+
+/**
+ * resets the allocation counters.
+ */
+void resetCounters()
+{
+    counters._mallocs = 0;
+    counters._reallocs = 0;
+    counters._frees = 0;
+}
+
+//------------------------HELPERS------------------------------------------------------------------
+
+/**
+ * @return the time of a monotonic clock, in nanoseconds.
+ */
+double nowNs()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1e9 + (double)now.tv_nsec;
+}
+
+/**
+ * allocates a block by malloc, or exits if the memory allocation failed.
+ * @param size: the num of bytes of the block.
+ * @return the address of the block.
+ */
+void *mallocOrExit(const size_t size)
+{
+    void *block = malloc(size);
+    if (block == NULL)
+    {
+        fprintf(stderr, "%s", MEM_SEG_ERR);
+        exit(EXIT_FAILURE);
+    }
+    return block;
+}
+
+/**
+ * keeps the compiler from dropping the computations whose results are only stored here.
+ */
+static volatile size_t sink;
+
+//------------------------STACK BENCHMARKS---------------------------------------------------------
+
+/**
+ * times STACK_OPS pushes, then STACK_OPS peeks and then STACK_OPS pops of a Stack (libstack.a)
+ * of elements of the supplied size, and prints their ns-per-op as a JSON object.
+ * @param elementSize: the num of bytes of an element.
+ */
+void benchStack(const size_t elementSize)
+{
+    Stack *stack = stackAlloc(elementSize);
+    char *element = (char *)mallocOrExit(elementSize);
+    memset(element, 1, elementSize);
+    if (stack == NULL)
+    {
+        exit(EXIT_FAILURE);
+    }
+    double start = nowNs();
+    for (size_t idx = 0; idx < STACK_OPS; ++idx)
+    {
+        element[0] = (char)idx;
+        push(stack, element);
+    }
+    const double pushNs = (nowNs() - start) / STACK_OPS;
+    start = nowNs();
+    for (size_t idx = 0; idx < STACK_OPS; ++idx)
+    {
+        sink += *(char *)peek(stack);
+    }
+    const double peekNs = (nowNs() - start) / STACK_OPS;
+    start = nowNs();
+    for (size_t idx = 0; idx < STACK_OPS; ++idx)
+    {
+        pop(stack, element);
+        sink += element[0];
+    }
+    const double popNs = (nowNs() - start) / STACK_OPS;
+    printf("    {\"element_size\": %zu, \"push_ns\": %.2f, \"peek_ns\": %.2f, \"pop_ns\": %.2f}", \
+           elementSize, pushNs, peekNs, popNs);
+    free(element);
+    freeStack(&stack);
+}
+
+/**
+ * times STACK_OPS pushes, then STACK_OPS peeks (tops) and then STACK_OPS pops of a typed stack
+ * of Values (a ValueStack, see program.h), to time against a Stack of elements of the same
+ * size, and prints their ns-per-op as a JSON object.
+ */
+void benchTypedStack()
+{
+    ValueStack stack;
+    valueStackInit(&stack);
+    double start = nowNs();
+    for (size_t idx = 0; idx < STACK_OPS; ++idx)
+    {
+        if (!valueStackPush(&stack, (Value)idx))
+        {
+            fprintf(stderr, "%s", MEM_SEG_ERR);
+            exit(EXIT_FAILURE);
+        }
+    }
+    const double pushNs = (nowNs() - start) / STACK_OPS;
+    start = nowNs();
+    for (size_t idx = 0; idx < STACK_OPS; ++idx)
+    {
+        sink += (size_t)*valueStackTop(&stack);
+    }
+    const double peekNs = (nowNs() - start) / STACK_OPS;
+    start = nowNs();
+    for (size_t idx = 0; idx < STACK_OPS; ++idx)
+    {
+        sink += (size_t)valueStackPop(&stack);
+    }
+    const double popNs = (nowNs() - start) / STACK_OPS;
+    printf("    {\"element_size\": %zu, \"push_ns\": %.2f, \"peek_ns\": %.2f, \"pop_ns\": %.2f}", \
+           sizeof(Value), pushNs, peekNs, popNs);
+    valueStackFree(&stack);
+}
+
+//------------------------EXPRESSION BENCHMARKS----------------------------------------------------
+
+/**
+ * represents a corpus of generated expressions with the fields:
+ * text: the expressions, one after the other (each is followed by a '\n').
+ * starts: the index in text of the first char of every expression.
+ * lengths: the num of chars of every expression (without the '\n').
+ */
+typedef struct Corpus
+{
+    char *_text;
+    size_t *_starts;
+    size_t *_lengths;
+}Corpus;
+
+/**
+ * @param state: the state of the generator (updated).
+ * @return the next pseudo random num of a xorshift generator.
+ */
+unsigned nextRandom(unsigned *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+/**
+ * appends an expression of the supplied nesting depth to <text>: a sum of products and
+ * quotients of digits, around the expression of the next depth in parenthesis. (so the values
+ * stay small, and no expression fails).
+ * @param text: the end of the text (updated).
+ * @param depth: the nesting depth (0 for an expression without parenthesis).
+ * @param state: the state of the generator.
+ */
+void generateExp(char **text, const size_t depth, unsigned *state)
+{
+    for (size_t level = 0; level <= depth; ++level)
+    {
+        const char *ops = "*/";
+        *text += sprintf(*text, "%u%c%u%c", 1 + nextRandom(state) % 9, ops[nextRandom(state) % 2], \
+                         1 + nextRandom(state) % 9, (nextRandom(state) % 2) ? '+' : '-');
+        if (level < depth)
+        {
+            *(*text)++ = '(';
+        }
+    }
+    *(*text)++ = '1';
+    for (size_t level = 0; level < depth; ++level)
+    {
+        *text += sprintf(*text, ")%c%u", (nextRandom(state) % 2) ? '+' : '-', \
+                         1 + nextRandom(state) % 9);
+    }
+}
+
+/**
+ * generates a corpus of CORPUS_LEN expressions of the supplied nesting depth.
+ * @param corpus: a Corpus object.
+ * @param depth: the nesting depth of the expressions.
+ */
+void generateCorpus(Corpus *corpus, const size_t depth)
+{
+    const size_t maxLen = 8 * (depth + 1) + 5 * depth + 2;
+    unsigned state = CORPUS_SEED;
+    corpus->_text = (char *)mallocOrExit(CORPUS_LEN * maxLen + 1);
+    corpus->_starts = (size_t *)mallocOrExit(sizeof(size_t) * CORPUS_LEN);
+    corpus->_lengths = (size_t *)mallocOrExit(sizeof(size_t) * CORPUS_LEN);
+    char *text = corpus->_text;
+    for (size_t idx = 0; idx < CORPUS_LEN; ++idx)
+    {
+        corpus->_starts[idx] = text - corpus->_text;
+        generateExp(&text, depth, &state);
+        corpus->_lengths[idx] = text - corpus->_text - corpus->_starts[idx];
+        *text++ = '\n';
+    }
+}
+
+/**
+ * frees the memory of the corpus.
+ * @param corpus: a Corpus object.
+ */
+void freeCorpus(Corpus *corpus)
+{
+    free(corpus->_text);
+    free(corpus->_starts);
+    free(corpus->_lengths);
+}
+
+/**
+ * prints the throughput of a phase, and its allocations, as JSON members.
+ * @param name: the name of the phase.
+ * @param elapsedNs: the time that the phase took on the corpus.
+ * @param isLast: whether it is the last member of the object.
+ */
+void printPhase(const char *name, const double elapsedNs, const int isLast)
+{
+    printf("\"%s\": {\"exps_per_sec\": %.0f, \"mallocs_per_exp\": %.3f, "
+           "\"reallocs_per_exp\": %.3f, \"frees_per_exp\": %.3f}%s", \
+           name, CORPUS_LEN / (elapsedNs / 1e9), (double)counters._mallocs / CORPUS_LEN, \
+           (double)counters._reallocs / CORPUS_LEN, (double)counters._frees / CORPUS_LEN, \
+           isLast ? "" : ", ");
+}
+
+/**
+ * times every phase of calc on a corpus of the supplied depth, and prints the expressions per
+ * second, and the mallocs, reallocs & frees per expression, of each as a JSON object. the phases
+ * are: expToInfix, infixToPostfix, compileProgram, runProgram (see main.c & program.h), and the
+ * fused evaluateDirect, which replaces the last 3 when the echo is off. the input of every phase
+ * is the output of the previous one, which is kept for the whole corpus before it is timed.
+ * @param depth: the nesting depth of the expressions of the corpus.
+ */
+void benchExpressions(const size_t depth)
+{
+    Corpus corpus;
+    generateCorpus(&corpus, depth);
+    Arena *kept = arenaAlloc(), *scratch = arenaAlloc();
+    Stack *operators = stackAlloc(sizeof(Token*));
+    Token ***infixes = (Token ***)mallocOrExit(sizeof(Token **) * CORPUS_LEN);
+    Token ***postfixes = (Token ***)mallocOrExit(sizeof(Token **) * CORPUS_LEN);
+    size_t *inSizes = (size_t *)mallocOrExit(sizeof(size_t) * CORPUS_LEN);
+    size_t *postSizes = (size_t *)mallocOrExit(sizeof(size_t) * CORPUS_LEN);
+    Program **programs = (Program **)mallocOrExit(sizeof(Program *) * CORPUS_LEN);
+    if (kept == NULL || scratch == NULL || operators == NULL)
+    {
+        exit(EXIT_FAILURE);
+    }
+    for (size_t idx = 0; idx < CORPUS_LEN; ++idx) // the inputs of the phases
+    {
+        inSizes[idx] = 0;
+        postSizes[idx] = 0;
+        const char *line = corpus._text + corpus._starts[idx];
+        infixes[idx] = expToInfix(kept, line, corpus._lengths[idx], &inSizes[idx]);
+        postfixes[idx] = infixToPostfix(kept, line, infixes[idx], inSizes[idx], operators, \
+                                        &postSizes[idx]);
+    }
+    printf("    {\"depth\": %zu, \"num_of_exps\": %d, ", depth, CORPUS_LEN);
+
+    resetCounters();
+    double start = nowNs();
+    for (size_t idx = 0; idx < CORPUS_LEN; ++idx)
+    {
+        size_t size = 0;
+        sink += (size_t)expToInfix(scratch, corpus._text + corpus._starts[idx], \
+                                   corpus._lengths[idx], &size);
+        arenaReset(scratch);
+    }
+    printPhase("exp_to_infix", nowNs() - start, 0);
+
+    resetCounters();
+    start = nowNs();
+    for (size_t idx = 0; idx < CORPUS_LEN; ++idx)
+    {
+        size_t size = 0;
+        sink += (size_t)infixToPostfix(scratch, corpus._text + corpus._starts[idx], \
+                                       infixes[idx], inSizes[idx], operators, &size);
+        arenaReset(scratch);
+    }
+    printPhase("infix_to_postfix", nowNs() - start, 0);
+
+    resetCounters();
+    start = nowNs();
+    for (size_t idx = 0; idx < CORPUS_LEN; ++idx)
+    {
+        programs[idx] = compileProgram(corpus._text + corpus._starts[idx], postfixes[idx], \
+                                       postSizes[idx]);
+    }
+    printPhase("compile_program", nowNs() - start, 0);
+
+    // the stacks are kept for the whole corpus, as an Evaluator keeps its own (see main.c):
+    EvalStacks stacks;
+    initEvalStacks(&stacks);
+    resetCounters();
+    start = nowNs();
+    for (size_t idx = 0; idx < CORPUS_LEN; ++idx)
+    {
+        Value value = 0;
+        sink += runProgram(programs[idx], NULL, &stacks, &value);
+        sink += (size_t)value;
+    }
+    printPhase("run_program", nowNs() - start, 0);
+
+    resetCounters();
+    start = nowNs();
+    for (size_t idx = 0; idx < CORPUS_LEN; ++idx)
+    {
+        Value value = 0;
+        sink += evaluateDirect(corpus._text + corpus._starts[idx], corpus._lengths[idx], \
+                               &stacks, &value);
+        sink += (size_t)value;
+    }
+    printPhase("evaluate_direct", nowNs() - start, 1);
+    printf("}");
+    freeEvalStacks(&stacks);
+
+    for (size_t idx = 0; idx < CORPUS_LEN; ++idx)
+    {
+        freeProgram(&programs[idx]);
+    }
+    free(programs);
+    free(infixes);
+    free(postfixes);
+    free(inSizes);
+    free(postSizes);
+    freeStack(&operators);
+    freeArena(&kept);
+    freeArena(&scratch);
+    freeCorpus(&corpus);
+}
+
+//------------------------RUN THE BENCHMARKS-------------------------------------------------------
+
+/**
+ * runs the benchmarks of libstack.a & of calc (see make bench), and prints their results to
+ * stdout as a JSON object.
+ * @return: 0.
+ */
+int main()
+{
+    printf("{\n  \"stack\": [\n");
+    for (size_t idx = 0; idx < NUM_OF(ELEMENT_SIZES); ++idx)
+    {
+        benchStack(ELEMENT_SIZES[idx]);
+        printf("%s\n", (idx + 1 < NUM_OF(ELEMENT_SIZES)) ? "," : "");
+    }
+    printf("  ],\n  \"typed_stack\": [\n");
+    benchTypedStack();
+    printf("\n  ],\n  \"expressions\": [\n");
+    for (size_t idx = 0; idx < NUM_OF(CORPUS_DEPTHS); ++idx)
+    {
+        benchExpressions(CORPUS_DEPTHS[idx]);
+        printf("%s\n", (idx + 1 < NUM_OF(CORPUS_DEPTHS)) ? "," : "");
+    }
+    printf("  ]\n}\n");
+    return 0;
+}
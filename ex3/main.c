@@ -1,10 +1,18 @@
 //-------------------INCLUDES----------------------------------------------------------------------
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <ctype.h>
 #include <memory.h>
-#include <math.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "arena.h"
 #include "token.h"
 #include "stack.h"
+#include "program.h"
+#include "queue.h"
 
 //----------------CONSTANTS------------------------------------------------------------------------
 /**
@@ -12,9 +20,48 @@
  */
 #define MAX_LINE_LEN 100
 
+/**
+ * the options of the program (see main).
+ */
+#define BATCH_OPTION "--batch"
+#define QUIET_OPTION "--quiet"
+#define THREADS_OPTION "--threads="
+#define FORMULA_OPTION "--formula="
+
+/**
+ * the num of bytes that batch mode reads from stdin at once (the buffer grows to hold longer
+ * lines), and the num of bytes of output that it keeps before writing them to stdout.
+ */
+#define BATCH_READ_LEN (1 << 20)
+#define BATCH_WRITE_LEN (1 << 20)
+
+/**
+ * the prefix of the value of every expression in the output.
+ */
+#define VALUE_PREFIX "The value is "
+
+/**
+ * the num of bytes of input in a batch of lines of the pipeline (a batch grows to hold longer
+ * lines), and the num of batches per worker that the pipeline keeps in flight.
+ */
+#define PIPELINE_BATCH_LEN (1 << 16)
+#define PIPELINE_BATCHES_PER_WORKER 4
+
+/**
+ * the num of rows of the input of formula mode that are kept in columns before they are
+ * evaluated.
+ */
+#define FORMULA_BLOCK_ROWS (1 << 16)
+
 //----Error syntax constants:
 #define MEM_SEG_ERR "Error in memory allocation.\n"
-#define DIV_BY_ZERO_ERR "Division by 0!\n"
+#define INVALID_EXP_ERR "Invalid expression.\n"
+#define USAGE_ERR "Usage: calc [--batch] [--quiet] [--threads=<n>] [--formula=<exp>]\n"
+#define READ_ERR "Error in reading the input.\n"
+#define WRITE_ERR "Error in writing the output.\n"
+#define UNBOUND_ERR "Variables are only bound in formula mode.\n"
+#define MISSING_COLUMN_ERR "A variable of the formula has no column.\n"
+#define INVALID_ROW_ERR "Invalid row.\n"
 
 //------------------------HELPERS------------------------------------------------------------------
 
@@ -22,42 +69,43 @@
 //--------------general functionality:
 /**
  * prints a mathematical expression (given as dynamic array of Token objects).
+ * @param stream: the stream to print to.
  * @param header: prefix string to declare the printing purpose.
+ * @param line: the line that holds the tokens.
  * @param exp: the dynamic array.
  * @param size: the size of the array.
  */
-void printExp(char *header, Token **exp, const size_t size)
+void printExp(FILE *stream, char *header, const char *line, Token **exp, const size_t size)
 {
-    printf("%s:", header);
+    fprintf(stream, "%s:", header);
     for(size_t idx = 0; idx < size; ++idx)
     {
-        printData(exp[idx]);
+        printData(stream, line, exp[idx]);
     }
-    printf("\n");
-    fflush(stdout);
+    fprintf(stream, "\n");
 }
 
 /**
- * deletes a dynamic array of tokens
- * @param tokens : a dynamic array of tokens.
- * @param size : the size of the array.
+ * allocates a block from the arena, or exits if the memory allocation failed.
+ * @param arena : an Arena object.
+ * @param size : the num of bytes of the block.
+ * @return the address of the block.
  */
-void deleteArrayOfTokens(Token **tokens, const size_t size)
+void *allocOrExit(Arena *arena, const size_t size)
 {
-    for (int idx = 0; idx < size; ++idx)
+    void *block = arenaMalloc(arena, size);
+    if (block == NULL)
     {
-        freeToken(tokens[idx]);
-        tokens[idx] = NULL;
+        exit(EXIT_FAILURE);
     }
-    free(tokens);
-    tokens = NULL;
+    return block;
 }
 
 //--------------expression to Infix form conversion:
 
 
 /**
- * @param c: char that is (, ), + , -, /, *, ^ or a digit! (assumed in ex. clarifications)
+ * @param c: char that is (, ), + , -, /, *, ^, a digit or a letter.
  * @return: enum ArithmeticTokens object that represents the type of <c>.
  */
 const enum ArithmeticTokens parseType(const char c)
@@ -75,49 +123,58 @@ const enum ArithmeticTokens parseType(const char c)
         case '^':
             return Operator;
         default:
-            return Operand;
+            return (isalpha(c) || c == '_') ? Variable : Operand;
     }
 }
 
 /**
  * converts a mathematical expression given in infix form as string,
- * to an array of tokens (see token.h).
+ * to an array of tokens (see token.h), which are views into <exp>.
+ * @param arena: the arena that holds the tokens, and the array.
  * @param exp: string that holds a valid mathematical expression.
  *             (i.e: valid parenthesis alignment, and valid use of the operators: +, -, *, \, ^).
- *             no other chars but digit exists in the expression.
+ *             no other chars but digits & names of variables (a letter or '_', followed by
+ *             letters, digits & '_') exist in the expression.
+ * @param expLen: the num of chars in the expression (without the '\n').
  * @param size: address of a counter to count the number of elements in list.
  * @return dynamic array that holds Token objects,
  *         representing the mathematical expression supplied (in infix form).
  */
-Token **expToInfix(char *exp, size_t *size)
+Token **expToInfix(Arena *arena, const char *exp, const size_t expLen, size_t *size)
 {
-    //preparations:
-    Token **tokens = NULL;
+    //preparations: every token takes a char at least
+    Token **tokens = (Token **)allocOrExit(arena, sizeof(Token*) * (expLen + 1));
     Token *newToken;
     enum ArithmeticTokens newType;
-    char *lp = exp, *rp = exp;
+    const char *lp = exp, *rp = exp;
+    const char *const end = exp + expLen;
 
-    while (*lp != '\0' && *lp != '\n')
+    while (lp < end)
     {
         //get the "substring" (by pointers) that holds the data
         ++rp;
         if (isdigit(*lp))
         {
-            while (isdigit(*rp))
+            while (rp < end && isdigit(*rp))
+            {
+                ++rp;
+            }
+        }
+        else if (isalpha(*lp) || *lp == '_')
+        {
+            while (rp < end && (isalnum(*rp) || *rp == '_'))
             {
                 ++rp;
             }
         }
         //initializations newToken
         newType = parseType(*lp);
-        newToken = initializeToken(lp, rp - lp, newType);
-        // put newToken in tokens
-        tokens = realloc(tokens, sizeof(Token*) * (*size + 1));
-        if(tokens == NULL)
+        newToken = initializeToken(arena, lp - exp, rp - lp, newType);
+        if(newToken == NULL)
         {
-            fprintf(stderr, "%s", MEM_SEG_ERR);
             exit(EXIT_FAILURE);
         }
+        // put newToken in tokens
         tokens[*size] = newToken;
         //next iter:
         ++(*size);
@@ -152,299 +209,1215 @@ const int precedence(const char operatorChar)
     }
 }
 /**
- * appends the supplied <currToken> to <postfix> at <size>.
- * @param postfix : a dynamic array of Token objects.
- * @param newToken : a new Token object.
- * @param size : the size of <postfix> before the append.
+ * @param operators: a stack of Token objects (their addresses).
+ * @param line: the line that holds the tokens.
+ * @return the first char of the token at the top of the stack.
  */
-void appendToPostfix(Token **postfix, Token *const newToken, size_t *const size)
+char peekChar(Stack *operators, const char *line)
 {
-    postfix = (Token **)realloc(postfix, sizeof(Token*) * (*size + 1));
-    postfix[*size] = newToken;
-    ++(*size);
+    return *getData(*(Token **)peek(operators), line);
 }
 
 /**
- * Pops the stack and appends the popped value to postfix.
- * @param postfixStack: the stack that we'll pop.
+ * pops the stack (of Token objects' addresses) and appends the popped token to <postfix>.
+ * @param operators: the stack that we'll pop.
  * @param postfix : a dynamic array of Token objects.
  * @param size : the size of <postfix> before the append.
  */
-
-void popAndAppendToPostfix(Stack *postfixStack, Token **postfix, size_t *size)
+void popAndAppendToPostfix(Stack *operators, Token **postfix, size_t *size)
 {
-    char *headData = (char*)malloc(sizeof(char) + 1);
-    pop(postfixStack, headData);
-    appendToPostfix(postfix, initializeToken(headData, strlen(headData), Operator), size);
-
+    pop(operators, &postfix[*size]);
+    ++(*size);
 }
 
 
 /**
  * converts a mathematical expression given as an array of tokens in infix form,
- * to an array of tokens in postfix form. returns this new array.
+ * to an array of the same tokens in postfix form (without the parenthesis). returns this new
+ * array.
+ * @param arena: the arena that holds the array.
+ * @param line: the line that holds the tokens.
  * @param infix: dynamic array that holds Token objects,
  *               representing mathematical expression in infix form.
  * @param inSize: the num of Token objects in the supplied <infix> array.
+ * @param operators: an empty stack of Token objects' addresses (left empty).
  * @param size: address of a counter to count the number of elements in the list we're returning.
  * @return dynamic array that holds Token objects,
  *         representing the mathematical expression supplied (in postfix form).
  */
-Token **infixToPostfix(Token **infix, const size_t inSize, size_t *const size)
+Token **infixToPostfix(Arena *arena, const char *line, Token **infix, const size_t inSize, \
+                       Stack *operators, size_t *const size)
 {
     //preparations:
-    Token **postfix = NULL;
-    Stack *postfixStack = stackAlloc(sizeof(char));
-    char *headData = malloc(sizeof(char) + 1);
-    char *toFree;
+    Token **postfix = (Token **)allocOrExit(arena, sizeof(Token*) * (inSize + 1));
+    Token *headToken;
 
     for(size_t idx = 0; idx < inSize; ++idx)
     {
-        const Token *const currToken = infix[idx];
+        Token *currToken = infix[idx];
         enum ArithmeticTokens currType = getType(currToken);
         switch (currType)
         {
             case Operand:
-                postfix = (Token **)realloc(postfix, sizeof(Token*) * (*size + 1));
-                postfix[*size] = cloneToken(currToken);
+            case Variable:
+                postfix[*size] = currToken;
                 ++(*size);
                 break;
 
             case  Left_Parenthesis:
-                push(postfixStack, (void *)getData(currToken));
+                push(operators, &currToken);
                 break;
 
             case Right_Parenthesis:
-                while (!isEmptyStack(postfixStack))
+                while (!isEmptyStack(operators))
                 {
-                    if(strcmp(toFree = peek(postfixStack), "(") == 0)//pop left parenthesis:
+                    if(peekChar(operators, line) == '(')//pop left parenthesis:
                     {
-                        pop(postfixStack, headData);
+                        pop(operators, &headToken);
                         break;
                     }
-                    pop(postfixStack, headData);
-                    postfix = (Token **)realloc(postfix, sizeof(Token*) * (*size + 1));
-                    postfix[*size] = initializeToken(headData, 1, Operator);
-                    ++(*size);
-                    free(toFree);
+                    popAndAppendToPostfix(operators, postfix, size);
                 }
                 break;
 
             case Operator:
-                if (isEmptyStack(postfixStack) || strcmp(toFree = peek(postfixStack), "(") == 0)
+                while (!isEmptyStack(operators) && peekChar(operators, line) != '(' &&\
+                       precedence(*getData(currToken, line)) <= \
+                       precedence(peekChar(operators, line)))
                 {
-                    push(postfixStack, (void *)getData(currToken));
+                    popAndAppendToPostfix(operators, postfix, size);
                 }
-                else
-                {
-                    while (!isEmptyStack(postfixStack) && strcmp(headData, "(")  != 0 &&\
-                           precedence(getData(currToken)[0]) <= precedence(headData[0]))
-                    {
-                        pop(postfixStack, headData);
-                        postfix = (Token **)realloc(postfix, sizeof(Token*) * (*size + 1));
-                        postfix[*size] = initializeToken(headData, 1, Operator);
-                        ++(*size);
-                    }
-                    push(postfixStack, (void *)getData(currToken));
-                }
-                free(toFree);
-                toFree = NULL;
+                push(operators, &currToken);
                 break;
         }
     }
-    while (!isEmptyStack(postfixStack))
+    while (!isEmptyStack(operators))
     {
-        pop(postfixStack, headData);
-        postfix = (Token **)realloc(postfix, sizeof(Token*) * (*size + 1));
-        postfix[*size] = initializeToken(headData, 1, Operator);
-        ++(*size);
+        popAndAppendToPostfix(operators, postfix, size);
     }
-    //restore memory
-    freeStack(&postfixStack);
-    free(headData);
     return postfix;
 }
 
-//-----------------Postfix expression evaluation:
+//-----------------Compiling the expression:
+
+/**
+ * parses & compiles a mathematical expression given in infix form as string (see program.h),
+ * and keeps it in the cache along with its infix & postfix forms, that are printed before its
+ * value.
+ * @param cache: the cache of compiled expressions.
+ * @param arena: the arena that holds the tokens of the expression (see arena.h), and is reset
+ *               once it is compiled.
+ * @param operators: an empty stack of Token objects' addresses (see infixToPostfix).
+ * @param exp: string that holds a valid mathematical expression.
+ * @param expLen: the num of chars in <exp>.
+ * @return the entry of the compiled expression (whose program is NULL if <exp> isn't a valid
+ *         expression).
+ */
+const CachedProgram *compileExp(ProgramCache *cache, Arena *arena, Stack *operators, \
+                                const char *exp, const size_t expLen)
+{
+    char *echo = NULL;
+    size_t echoLen = 0;
+    FILE *echoStream = open_memstream(&echo, &echoLen);
+    if (echoStream == NULL)
+    {
+        fprintf(stderr, "%s", MEM_SEG_ERR);
+        exit(EXIT_FAILURE);
+    }
+    //translates the exp to infix expression & prints exp in infix form:
+    size_t inSize = 0;
+    Token **infix = expToInfix(arena, exp, expLen, &inSize);
+    printExp(echoStream, "infix", exp, infix, inSize);
+
+    //translates from infix to postfix & prints the exp in postfix form:
+    size_t postSize = 0;
+    Token** postfix = infixToPostfix(arena, exp, infix, inSize, operators, &postSize);
+    printExp(echoStream, "postfix", exp, postfix, postSize);
+    fclose(echoStream);
+
+    //lowers the exp in postfix form to bytecode:
+    Program *program = compileProgram(exp, postfix, postSize);
+    arenaReset(arena); // restore memory
+    const CachedProgram *entry = storeProgram(cache, exp, expLen, program, echo);
+    if (entry == NULL)
+    {
+        exit(EXIT_FAILURE);
+    }
+    return entry;
+}
+
 /**
- * @param a: address of an int
- * @param b: address of an int
- * @return a + b.
+ * @param cache: the cache of compiled expressions.
+ * @param arena: the arena that holds the tokens of the expression (see compileExp).
+ * @param operators: an empty stack of Token objects' addresses (see infixToPostfix).
+ * @param exp: string that holds a valid mathematical expression.
+ * @param expLen: the num of chars in <exp>.
+ * @return the entry of the compiled expression: a repeated expression is taken from the cache,
+ *         without parsing it again.
  */
-int add(const int *const a, const int *const b)
+const CachedProgram *findExp(ProgramCache *cache, Arena *arena, Stack *operators, \
+                             const char *exp, const size_t expLen)
 {
-    return (*a) + (*b);
+    const CachedProgram *entry = lookupProgram(cache, exp, expLen);
+    return (entry != NULL) ? entry : compileExp(cache, arena, operators, exp, expLen);
 }
 
+//------------------------BATCH MODE---------------------------------------------------------------
+
+/**
+ * represents the state that evaluating lines needs, which every thread has its own of, with the
+ * fields:
+ * cache: the cache of compiled expressions.
+ * arena: the arena that holds the tokens of an expression (see compileExp).
+ * operators: an empty stack of Token objects' addresses (see infixToPostfix).
+ * stacks: the stacks that the expressions are evaluated on (see EvalStacks), whose buffers are
+ *         kept from one line to the next.
+ * echo: whether to output the infix & postfix forms of the expressions before their values.
+ */
+typedef struct Evaluator
+{
+    ProgramCache *_cache;
+    Arena *_arena;
+    Stack *_operators;
+    EvalStacks _stacks;
+    int _echo;
+}Evaluator;
+
+/**
+ * represents a message of an Output to stderr, with the fields:
+ * offset: the num of bytes of the output's data that are written before it.
+ * message: the message (a constant string).
+ */
+typedef struct Diagnostic
+{
+    size_t _offset;
+    const char *_message;
+}Diagnostic;
+
 /**
- * @param a: address of an int
- * @param b: address of an int
- * @return a - b.
+ * represents the output of batch mode with the fields:
+ * data: the bytes that weren't written yet.
+ * size: the num of bytes in data.
+ * capacity: the num of bytes that data has room for (they are written once it is full).
+ * fd: the file descriptor that the output is written to, or -1 to keep all of it in memory
+ *     (then data grows instead).
+ * diagnostics: the messages to stderr of an output that is kept in memory (see reportOutput),
+ *              in the order of their offsets.
+ * numOfDiagnostics: the num of diagnostics.
+ * diagnosticsCapacity: the num of diagnostics that diagnostics has room for.
  */
-int sub(const int *const a, const int *const b)
+typedef struct Output
 {
-    return (*a) - (*b);
+    char *_data;
+    size_t _size;
+    size_t _capacity;
+    int _fd;
+    Diagnostic *_diagnostics;
+    size_t _numOfDiagnostics;
+    size_t _diagnosticsCapacity;
+}Output;
+
+/**
+ * initializes the supplied evaluator.
+ * @param evaluator: an Evaluator object.
+ * @param echo: whether to output the infix & postfix forms of the expressions.
+ * @return 1 if succeed, 0 if the memory allocation failed.
+ */
+int initEvaluator(Evaluator *evaluator, const int echo)
+{
+    evaluator->_cache = cacheAlloc();
+    evaluator->_arena = arenaAlloc();
+    evaluator->_operators = stackAlloc(sizeof(Token*));
+    initEvalStacks(&evaluator->_stacks);
+    evaluator->_echo = echo;
+    return evaluator->_cache != NULL && evaluator->_arena != NULL && \
+           evaluator->_operators != NULL;
 }
 
 /**
- * @param a: address of an int
- * @param b: address of an int
- * @return a * b
+ * frees the memory of the supplied evaluator.
+ * @param evaluator: an Evaluator object.
  */
-int mul(const int *const a, const int *const b)
+void freeEvaluator(Evaluator *evaluator)
 {
-    return (*a) * (*b);
+    freeCache(&evaluator->_cache);
+    freeArena(&evaluator->_arena);
+    freeStack(&evaluator->_operators);
+    freeEvalStacks(&evaluator->_stacks);
 }
 
 /**
- * @param a: address of an int
- * @param b: address of an int
- * @return a / b.
- *         if b is 0:  throws an error and exits.
+ * writes all the supplied bytes to the file descriptor.
+ * if the writing failed: prints an error and exits.
+ * @param fd: the file descriptor.
+ * @param data: the bytes.
+ * @param size: the num of bytes.
  */
-int divide(const int *const a, const int *const b)
+void writeAll(const int fd, const char *data, const size_t size)
 {
-    if(*b == 0)
+    size_t written = 0;
+    while (written < size)
     {
-        fprintf(stderr, "%s", DIV_BY_ZERO_ERR);
-        exit(EXIT_FAILURE);
+        const ssize_t result = write(fd, data + written, size - written);
+        if (result < 0 && errno != EINTR)
+        {
+            fprintf(stderr, "%s", WRITE_ERR);
+            exit(EXIT_FAILURE);
+        }
+        written += (result > 0) ? (size_t)result : 0;
     }
-    return (*a) / (*b);
 }
 
 /**
- *
- * @param a: address of an int
- * @param b: address of an int
- * @return: a ^ b
+ * writes all the bytes of the output to its file descriptor, with its diagnostics to stderr
+ * between them (each after the bytes before its offset), and empties it.
+ * if the writing failed: prints an error and exits.
+ * @param output: an Output object.
  */
-int power(const int *const a, const int *const b)
+void flushOutput(Output *output)
 {
-    return (int) pow((*a), (*b));
+    size_t written = 0;
+    for (size_t idx = 0; idx < output->_numOfDiagnostics; ++idx)
+    {
+        const Diagnostic *diagnostic = &output->_diagnostics[idx];
+        writeAll(output->_fd, output->_data + written, diagnostic->_offset - written);
+        written = diagnostic->_offset;
+        fprintf(stderr, "%s", diagnostic->_message);
+    }
+    writeAll(output->_fd, output->_data + written, output->_size - written);
+    output->_size = 0;
+    output->_numOfDiagnostics = 0;
 }
 
 /**
- * @param a: address of an int
- * @param b: address of an int
- * @param f: a function.
- * @return f(a,b)
+ * reports a message to stderr after the bytes of the output so far: it is printed at once
+ * (after the output is flushed), or, if the output is kept in memory, when the output is written
+ * (see flushOutput), so the messages stay in the order of the lines that caused them.
+ * @param output: an Output object.
+ * @param message: the message (a constant string).
  */
-int computeExp(const int *const a, const int *const b, \
-               int (*f)(const int *const, const int *const))
+void reportOutput(Output *output, const char *message)
 {
-    return f(a, b);
+    if (output->_fd >= 0)
+    {
+        flushOutput(output);
+        fprintf(stderr, "%s", message);
+        return;
+    }
+    if (output->_numOfDiagnostics == output->_diagnosticsCapacity)
+    {
+        const size_t capacity = 2 * output->_diagnosticsCapacity + 1;
+        Diagnostic *grown = (Diagnostic *)realloc(output->_diagnostics, \
+                                                  capacity * sizeof(Diagnostic));
+        if (grown == NULL)
+        {
+            fprintf(stderr, "%s", MEM_SEG_ERR);
+            exit(EXIT_FAILURE);
+        }
+        output->_diagnostics = grown;
+        output->_diagnosticsCapacity = capacity;
+    }
+    output->_diagnostics[output->_numOfDiagnostics++] = (Diagnostic){output->_size, message};
 }
 
 /**
- * @param a: address of an int.
- * @param b : address of an int.
- * @param op : char that is one of the followings: '+', '-', '*', '/', '^'.
- * @return : the result of: <op>(<a>,<b>).
+ * appends the supplied bytes to the output (it is flushed first if they don't fit, or grows if
+ * it is kept in memory).
+ * @param output: an Output object.
+ * @param data: the bytes.
+ * @param size: the num of bytes.
  */
-int computeRes(const int *const a, const int *const b, const char op)
+void appendOutput(Output *output, const char *data, const size_t size)
 {
-    int res;
-    switch (op)
+    if (output->_capacity - output->_size < size)
     {
-        case '+':
-            res = computeExp(a, b, add);
-            break;
-        case '-':
-            res = computeExp(a, b, sub);
-            break;
-        case '*':
-            res = computeExp(a, b, mul);
-            break;
-        case '/':
-            res = computeExp(a, b, divide);
-            break;
-        case '^':
-            res = computeExp(a, b, power);
-            break;
-        default:
-            res = 0;
+        if (output->_fd < 0)
+        {
+            const size_t capacity = 2 * output->_capacity + size;
+            char *grown = (char *)realloc(output->_data, capacity);
+            if (grown == NULL)
+            {
+                fprintf(stderr, "%s", MEM_SEG_ERR);
+                exit(EXIT_FAILURE);
+            }
+            output->_data = grown;
+            output->_capacity = capacity;
+        }
+        else
+        {
+            flushOutput(output);
+            if (output->_capacity < size) // bigger than the whole buffer: written as is
+            {
+                writeAll(output->_fd, data, size);
+                return;
+            }
+        }
+    }
+    memcpy(output->_data + output->_size, data, size);
+    output->_size += size;
+}
+
+/**
+ * appends "The value is <value>" (and a '\n') to the output, formatting <value> by hand, since
+ * the fused evaluation is otherwise cheaper than sprintf.
+ * @param output: an Output object.
+ * @param value: the value of an expression.
+ */
+void appendValue(Output *output, const Value value)
+{
+    char line[sizeof(VALUE_PREFIX "-9223372036854775808\n")];
+    char digits[sizeof("9223372036854775808")];
+    uint64_t magnitude = (value < 0) ? 0u - (uint64_t)value : (uint64_t)value;
+    size_t numOfDigits = 0, size = sizeof(VALUE_PREFIX) - 1;
+    do
+    {
+        digits[numOfDigits++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    memcpy(line, VALUE_PREFIX, size);
+    if (value < 0)
+    {
+        line[size++] = '-';
     }
-    return res;
+    while (numOfDigits > 0)
+    {
+        line[size++] = digits[--numOfDigits];
+    }
+    line[size++] = '\n';
+    appendOutput(output, line, size);
 }
 
+/**
+ * flushes the output, prints the error that stopped an evaluation and exits.
+ * @param output: an Output object.
+ * @param status: the error (see EvalStatus).
+ */
+void exitOnError(Output *output, const EvalStatus status)
+{
+    flushOutput(output);
+    fprintf(stderr, "%s", (status == Eval_Division_By_Zero) ? DIV_BY_ZERO_ERR : OVERFLOW_ERR);
+    exit(EXIT_FAILURE);
+}
 
+/**
+ * evaluates a single line of input, and appends its output to <output>.
+ * @param evaluator: the state of the evaluation (see Evaluator).
+ * @param output: an Output object.
+ * @param exp: string that holds a valid mathematical expression.
+ * @param expLen: the num of chars in <exp>.
+ * @return Eval_Succeed, or the error that stopped the evaluation (then only the echo is output).
+ */
+EvalStatus evaluateLine(Evaluator *evaluator, Output *output, const char *exp, \
+                        const size_t expLen)
+{
+    Value value;
+    // without the echo, the tokens & the postfix form aren't needed:
+    if (!evaluator->_echo && evaluateDirect(exp, expLen, &evaluator->_stacks, &value))
+    {
+        appendValue(output, value);
+        return Eval_Succeed;
+    }
+    const CachedProgram *entry = findExp(evaluator->_cache, evaluator->_arena, \
+                                         evaluator->_operators, exp, expLen);
+    if (evaluator->_echo)
+    {
+        appendOutput(output, entry->_echo, strlen(entry->_echo));
+    }
+    if (entry->_program == NULL || entry->_program->_numOfVariables > 0)
+    {
+        reportOutput(output, (entry->_program == NULL) ? INVALID_EXP_ERR : UNBOUND_ERR);
+        return Eval_Succeed;
+    }
+    const EvalStatus status = runProgram(entry->_program, NULL, &evaluator->_stacks, &value);
+    if (status == Eval_Succeed)
+    {
+        appendValue(output, value);
+    }
+    return status;
+}
 
 /**
- * evaluates the expression supplied in <postfix>, and returns the result.
- * @param postfix: dynamic array that holds Token objects,
- *               representing mathematical expression in postfix form.
- * @param size: the number of elements in <postfix>.
- * @return the evaluation's result.
+ * evaluates the complete lines of a block of input, and appends their output to <output>.
+ * @param evaluator: the state of the evaluation (see Evaluator).
+ * @param output: an Output object.
+ * @param input: the block.
+ * @param size: the num of chars in <input>.
+ * @param isLast: whether <input> is the end of the input, so its last line is complete even
+ *                without a '\n'.
+ * @param consumed: receives the num of chars of the lines that were evaluated.
+ * @return Eval_Succeed, or the error that stopped the evaluation of a line (then the lines
+ *         after it aren't evaluated).
  */
-int evaluateExp(Token **postfix, const size_t size)
+EvalStatus evaluateBlock(Evaluator *evaluator, Output *output, const char *input, \
+                         const size_t size, const int isLast, size_t *consumed)
 {
-    //preparations:
-    Stack *evalStack = stackAlloc(sizeof(int));
-    int *aPtr = (int *)malloc(sizeof(int) + 1);
-    int *bPtr = (int *)malloc(sizeof(int) + 1);
+    const char *lineStart = input;
+    const char *const end = input + size;
+    const char *lineEnd;
+    EvalStatus status = Eval_Succeed;
+    while (status == Eval_Succeed && \
+           (lineEnd = memchr(lineStart, '\n', end - lineStart)) != NULL)
+    {
+        status = evaluateLine(evaluator, output, lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+    }
+    if (status == Eval_Succeed && isLast && lineStart < end) // the last line has no '\n'
+    {
+        status = evaluateLine(evaluator, output, lineStart, end - lineStart);
+        lineStart = end;
+    }
+    *consumed = lineStart - input;
+    return status;
+}
 
-    for(size_t idx = 0; idx < size; ++idx)
+/**
+ * reads from stdin until <*input> is full, or the input ends. <*input> grows when it is full
+ * already (to hold lines longer than it).
+ * if the reading failed: prints an error and exits.
+ * @param input: the address of a buffer (malloc'd).
+ * @param size: the num of chars in the buffer (updated).
+ * @param capacity: the num of chars that the buffer has room for (updated).
+ * @return 1 if the input ended, 0 otherwise.
+ */
+int readBlock(char **input, size_t *size, size_t *capacity)
+{
+    if (*size == *capacity) // a line that is longer than the buffer:
+    {
+        char *grown = (char *)realloc(*input, 2 * *capacity);
+        if (grown == NULL)
+        {
+            fprintf(stderr, "%s", MEM_SEG_ERR);
+            exit(EXIT_FAILURE);
+        }
+        *input = grown;
+        *capacity *= 2;
+    }
+    while (*size < *capacity)
     {
-        const Token *currToken = postfix[idx];
-        const enum ArithmeticTokens currType = getType(currToken);
-        if(currType ==  Operand)
+        const ssize_t result = read(STDIN_FILENO, *input + *size, *capacity - *size);
+        if (result == 0)
+        {
+            return 1;
+        }
+        if (result < 0 && errno != EINTR)
         {
-            //pushes to stack as int
-            char *ptr;
-            int operand = (int)strtol(getData(currToken), &ptr, 10);
-            push(evalStack, (void *)&operand);
+            fprintf(stderr, "%s", READ_ERR);
+            exit(EXIT_FAILURE);
         }
-        else if (currType == Operator)
+        *size += (result > 0) ? (size_t)result : 0;
+    }
+    return 0;
+}
+
+/**
+ * evaluates every line of stdin, which is read in blocks of BATCH_READ_LEN bytes, and split to
+ * lines of any length. the output is written in blocks of BATCH_WRITE_LEN bytes.
+ * if the evaluation of an expression fails: prints an error and exits.
+ * @param evaluator: the state of the evaluation (see Evaluator).
+ * @param output: an empty Output object (left empty).
+ */
+void runBatch(Evaluator *evaluator, Output *output)
+{
+    size_t capacity = BATCH_READ_LEN, size = 0;
+    char *input = (char *)malloc(capacity);
+    if (input == NULL)
+    {
+        fprintf(stderr, "%s", MEM_SEG_ERR);
+        exit(EXIT_FAILURE);
+    }
+    int isEof = 0;
+    while (!isEof)
+    {
+        isEof = readBlock(&input, &size, &capacity);
+        // evaluates the complete lines, and keeps the rest for the next block:
+        size_t consumed;
+        const EvalStatus status = evaluateBlock(evaluator, output, input, size, isEof, &consumed);
+        if (status != Eval_Succeed)
         {
-            pop(evalStack, bPtr);
-            pop(evalStack, aPtr);
-            int res = computeRes(aPtr, bPtr, *getData(currToken));
-            push(evalStack, (void *)&res);
+            exitOnError(output, status);
         }
+        size -= consumed;
+        memmove(input, input + consumed, size);
     }
-    pop(evalStack, aPtr);
-    int res = *aPtr;
-    //restore memory:
-    freeStack(&evalStack);
-    free(aPtr);
-    free(bPtr);
-    return res;
+    flushOutput(output);
+    free(input);
 }
 
+//------------------------PIPELINE MODE------------------------------------------------------------
 
-//------------------------RUN THE PROGRAM----------------------------------------------------------
+/**
+ * represents a batch of complete lines of the input with the fields:
+ * seq: the index of the batch in the input.
+ * input: the lines.
+ * size: the num of chars in input.
+ * capacity: the num of chars that input has room for.
+ * output: the output of the lines (kept in memory).
+ * status: the error that stopped the evaluation of a line (then the lines after it aren't
+ *         evaluated), or Eval_Succeed.
+ */
+typedef struct Batch
+{
+    size_t _seq;
+    char *_input;
+    size_t _size;
+    size_t _capacity;
+    Output _output;
+    EvalStatus _status;
+}Batch;
 
 /**
- * runs the program.
- * @return: 0 i succeed, 1 otherwise.
+ * represents the pipeline of the input: a reader thread splits it into batches of lines (see
+ * readBatches), a pool of workers evaluates them in parallel, each by its own Evaluator (see
+ * evaluateBatches), and the main thread writes their outputs in the order of the input (see
+ * writeBatches). the fields are:
+ * work: the batches that were read, to evaluate (read by the reader, evaluated by any worker).
+ * done: the batches that were evaluated, to write (by any worker, written by the writer).
+ * free: the batches that were written, to read into again (by the writer, for the reader).
+ * numOfBatches: the num of batches in flight, which bounds the memory of the pipeline.
+ * numOfWorkers: the num of workers.
+ * total: the num of batches in the input (SIZE_MAX until the reader reaches its end).
+ * echo: whether to output the infix & postfix forms of the expressions.
  */
-int main()
+typedef struct Pipeline
 {
-    char buff[MAX_LINE_LEN + 1]; //including '\n'
-    // reads infix expression as string from user:
-    char *result = fgets(buff, MAX_LINE_LEN + 1, stdin);
-    while (result != NULL)
+    MpmcQueue *_work;
+    MpmcQueue *_done;
+    SpscQueue *_free;
+    size_t _numOfBatches;
+    size_t _numOfWorkers;
+    atomic_size_t _total;
+    int _echo;
+}Pipeline;
+
+/**
+ * creates a new, empty, Batch object.
+ * @return the batch (exits if the memory allocation failed).
+ */
+Batch *batchAlloc()
+{
+    Batch *batch = (Batch *)malloc(sizeof(Batch));
+    char *input = (char *)malloc(PIPELINE_BATCH_LEN);
+    char *output = (char *)malloc(PIPELINE_BATCH_LEN);
+    if (batch == NULL || input == NULL || output == NULL)
+    {
+        fprintf(stderr, "%s", MEM_SEG_ERR);
+        exit(EXIT_FAILURE);
+    }
+    batch->_input = input;
+    batch->_size = 0;
+    batch->_capacity = PIPELINE_BATCH_LEN;
+    batch->_output = (Output){output, 0, PIPELINE_BATCH_LEN, -1, NULL, 0, 0};
+    return batch;
+}
+
+/**
+ * deletes the batch & frees the memory
+ * @param batch: a Batch object.
+ */
+void freeBatch(Batch *batch)
+{
+    free(batch->_input);
+    free(batch->_output._data);
+    free(batch->_output._diagnostics);
+    free(batch);
+}
+
+/**
+ * the body of the reader of a Pipeline: reads stdin into batches of complete lines, and pushes
+ * them to the workers, until the input ends. the batches are taken from the ones that were
+ * written, or allocated while there are less than numOfBatches of them.
+ * @param arg: the Pipeline.
+ * @return NULL.
+ */
+void *readBatches(void *arg)
+{
+    Pipeline *pipeline = (Pipeline *)arg;
+    size_t seq = 0, numOfAllocated = 1;
+    Batch *batch = batchAlloc();
+    int isEof = 0;
+    while (!isEof)
+    {
+        isEof = readBlock(&batch->_input, &batch->_size, &batch->_capacity);
+        const char *lastLine = batch->_input + batch->_size;
+        while (!isEof && lastLine > batch->_input && lastLine[-1] != '\n')
+        {
+            --lastLine;
+        }
+        if (!isEof && lastLine == batch->_input)
+        {
+            continue; // a line that is longer than the batch
+        }
+        // the next batch starts with the remainder of the last line:
+        Batch *next = NULL;
+        if (!isEof)
+        {
+            if (!spscTryPop(pipeline->_free, (void **)&next))
+            {
+                if (numOfAllocated < pipeline->_numOfBatches)
+                {
+                    next = batchAlloc();
+                    ++numOfAllocated;
+                }
+                else
+                {
+                    next = (Batch *)spscPop(pipeline->_free);
+                }
+            }
+            const size_t cut = lastLine - batch->_input;
+            next->_size = batch->_size - cut;
+            while (next->_capacity < next->_size)
+            {
+                next->_capacity *= 2;
+                next->_input = (char *)realloc(next->_input, next->_capacity);
+                if (next->_input == NULL)
+                {
+                    fprintf(stderr, "%s", MEM_SEG_ERR);
+                    exit(EXIT_FAILURE);
+                }
+            }
+            memcpy(next->_input, batch->_input + cut, next->_size);
+            batch->_size = cut;
+        }
+        if (batch->_size > 0)
+        {
+            batch->_seq = seq++;
+            mpmcPush(pipeline->_work, batch);
+        }
+        else
+        {
+            freeBatch(batch);
+        }
+        batch = next;
+    }
+    atomic_store(&pipeline->_total, seq);
+    for (size_t idx = 0; idx < pipeline->_numOfWorkers; ++idx)
+    {
+        mpmcPush(pipeline->_work, NULL); // no more batches
+    }
+    mpmcPush(pipeline->_done, NULL); // wakes the writer up to the total
+    return NULL;
+}
+
+/**
+ * the body of every worker of a Pipeline: evaluates batches (with an Evaluator of its own)
+ * until there are no more.
+ * @param arg: the Pipeline.
+ * @return NULL.
+ */
+void *evaluateBatches(void *arg)
+{
+    Pipeline *pipeline = (Pipeline *)arg;
+    Evaluator evaluator;
+    if (!initEvaluator(&evaluator, pipeline->_echo))
+    {
+        exit(EXIT_FAILURE);
+    }
+    Batch *batch;
+    while ((batch = (Batch *)mpmcPop(pipeline->_work)) != NULL)
+    {
+        size_t consumed;
+        batch->_output._size = 0;
+        batch->_output._numOfDiagnostics = 0;
+        batch->_status = evaluateBlock(&evaluator, &batch->_output, batch->_input, \
+                                       batch->_size, 1, &consumed);
+        mpmcPush(pipeline->_done, batch);
+    }
+    freeEvaluator(&evaluator);
+    return NULL;
+}
+
+/**
+ * writes the outputs of the batches of a Pipeline to stdout in the order of the input, as soon
+ * as each is evaluated, and hands the batches back to the reader.
+ * if the evaluation of a batch fails: writes the output before it, prints an error and exits.
+ * @param pipeline: the Pipeline.
+ */
+void writeBatches(Pipeline *pipeline)
+{
+    Batch **pending = (Batch **)calloc(pipeline->_numOfBatches, sizeof(Batch *));
+    if (pending == NULL)
+    {
+        fprintf(stderr, "%s", MEM_SEG_ERR);
+        exit(EXIT_FAILURE);
+    }
+    size_t next = 0;
+    while (next < atomic_load(&pipeline->_total))
+    {
+        // (at most numOfBatches batches are in flight, so they don't share a pending slot)
+        Batch *batch = pending[next % pipeline->_numOfBatches];
+        if (batch == NULL)
+        {
+            batch = (Batch *)mpmcPop(pipeline->_done);
+            if (batch != NULL) // (else the total is known)
+            {
+                pending[batch->_seq % pipeline->_numOfBatches] = batch;
+            }
+            continue;
+        }
+        Output output = batch->_output;
+        output._fd = STDOUT_FILENO;
+        if (batch->_status != Eval_Succeed)
+        {
+            exitOnError(&output, batch->_status);
+        }
+        flushOutput(&output);
+        pending[next % pipeline->_numOfBatches] = NULL;
+        ++next;
+        spscPush(pipeline->_free, batch);
+    }
+    free(pending);
+}
+
+/**
+ * evaluates every line of stdin by a pipeline of a reader, <numOfWorkers> workers and a writer
+ * (see Pipeline). the output is the same as of runBatch, and so are its messages to stderr,
+ * which the writer prints in the order of the lines (see reportOutput).
+ * @param numOfWorkers: the num of workers.
+ * @param echo: whether to output the infix & postfix forms of the expressions.
+ */
+void runPipeline(const size_t numOfWorkers, const int echo)
+{
+    Pipeline pipeline;
+    pipeline._numOfWorkers = numOfWorkers;
+    pipeline._numOfBatches = PIPELINE_BATCHES_PER_WORKER * numOfWorkers;
+    // every queue can hold all of the batches (and the ends of the workers & the writer), so it
+    // is never full:
+    pipeline._work = mpmcAlloc(pipeline._numOfBatches + numOfWorkers);
+    pipeline._done = mpmcAlloc(pipeline._numOfBatches + 1);
+    pipeline._free = spscAlloc(pipeline._numOfBatches);
+    atomic_init(&pipeline._total, SIZE_MAX);
+    pipeline._echo = echo;
+    pthread_t *threads = (pthread_t *)malloc((numOfWorkers + 1) * sizeof(pthread_t));
+    if (pipeline._work == NULL || pipeline._done == NULL || pipeline._free == NULL || \
+        threads == NULL)
+    {
+        exit(EXIT_FAILURE);
+    }
+    size_t numOfStarted = 0;
+    while (numOfStarted < numOfWorkers && pthread_create(&threads[numOfStarted + 1], NULL, \
+                                                         evaluateBatches, &pipeline) == 0)
+    {
+        ++numOfStarted;
+    }
+    if (numOfStarted == 0)
+    {
+        exit(EXIT_FAILURE);
+    }
+    pipeline._numOfWorkers = numOfStarted; // (before the reader that ends the workers starts)
+    if (pthread_create(&threads[0], NULL, readBatches, &pipeline) != 0)
+    {
+        exit(EXIT_FAILURE);
+    }
+    writeBatches(&pipeline);
+    for (size_t idx = 0; idx <= numOfStarted; ++idx)
+    {
+        pthread_join(threads[idx], NULL);
+    }
+    Batch *batch;
+    while (spscTryPop(pipeline._free, (void **)&batch))
+    {
+        freeBatch(batch);
+    }
+    freeMpmc(&pipeline._work);
+    freeMpmc(&pipeline._done);
+    freeSpsc(&pipeline._free);
+    free(threads);
+}
+
+//------------------------FORMULA MODE-------------------------------------------------------------
+
+/**
+ * represents the values of the variables of a formula in a block of rows of the input, by
+ * columns, with the fields:
+ * columns: the column of every variable of the formula (in the order of its Program), each of
+ *          FORMULA_BLOCK_ROWS values.
+ * numOfRows: the num of rows in the columns.
+ * bindings: the index of the variable of every field of a row, or -1 if it isn't used.
+ * numOfFields: the num of fields in every row.
+ * values: the values of the rows (see runProgramOnColumns).
+ */
+typedef struct Table
+{
+    Value **_columns;
+    size_t _numOfRows;
+    long *_bindings;
+    size_t _numOfFields;
+    Value *_values;
+}Table;
+
+/**
+ * @param c: a char of a row of the input of formula mode.
+ * @return 1 if <c> separates the fields of the row (a space, a tab, a comma or a '\r'), 0
+ *         otherwise.
+ */
+int isSeparator(const char c)
+{
+    return c == ' ' || c == '\t' || c == ',' || c == '\r';
+}
+
+/**
+ * @param field: the end of the last field (or the line's beginning).
+ * @param end: the line's end.
+ * @param fieldEnd: receives the end of the next field.
+ * @return the beginning of the next field of the line (which is <*fieldEnd> if there are no more
+ *         fields).
+ */
+const char *nextField(const char *field, const char *end, const char **fieldEnd)
+{
+    while (field < end && isSeparator(*field))
+    {
+        ++field;
+    }
+    const char *cursor = field;
+    while (cursor < end && !isSeparator(*cursor))
+    {
+        ++cursor;
+    }
+    *fieldEnd = cursor;
+    return field;
+}
+
+/**
+ * @param field: the chars of an integer (with an optional '-').
+ * @param length: the num of chars in <field>.
+ * @param value: receives the integer.
+ * @return 1 if succeed, 0 if the field isn't an integer that fits in a Value.
+ */
+int parseValue(const char *field, const size_t length, Value *value)
+{
+    const int isNegative = (length > 0 && field[0] == '-');
+    if ((size_t)isNegative == length)
+    {
+        return 0;
+    }
+    Value parsed = 0; // accumulated negatively, to hold INT64_MIN
+    for (size_t idx = isNegative; idx < length; ++idx)
+    {
+        if (!isdigit(field[idx]) || __builtin_mul_overflow(parsed, 10, &parsed) || \
+            __builtin_sub_overflow(parsed, field[idx] - '0', &parsed))
+        {
+            return 0;
+        }
+    }
+    if (!isNegative && __builtin_sub_overflow(0, parsed, &parsed))
+    {
+        return 0;
+    }
+    *value = parsed;
+    return 1;
+}
+
+/**
+ * initializes the table of a formula by the header of the input: the names of the fields of the
+ * rows. every variable of the formula is bound to the first field of its name.
+ * if a variable has no field: prints an error and exits.
+ * @param table: a Table object.
+ * @param program: the formula.
+ * @param header: the line of the names of the fields.
+ * @param headerLen: the num of chars in <header>.
+ */
+void initTable(Table *table, const Program *program, const char *header, const size_t headerLen)
+{
+    const char *const end = header + headerLen;
+    const char *fieldEnd = header;
+    table->_numOfFields = 0;
+    while (nextField(fieldEnd, end, &fieldEnd) < fieldEnd)
+    {
+        ++table->_numOfFields;
+    }
+    table->_bindings = (long *)malloc(sizeof(long) * (table->_numOfFields + 1));
+    table->_columns = (Value **)calloc(program->_numOfVariables + 1, sizeof(Value *));
+    table->_values = (Value *)malloc(sizeof(Value) * FORMULA_BLOCK_ROWS);
+    table->_numOfRows = 0;
+    if (table->_bindings == NULL || table->_columns == NULL || table->_values == NULL)
+    {
+        fprintf(stderr, "%s", MEM_SEG_ERR);
+        exit(EXIT_FAILURE);
+    }
+    fieldEnd = header;
+    for (size_t idx = 0; idx < table->_numOfFields; ++idx)
+    {
+        const char *field = nextField(fieldEnd, end, &fieldEnd);
+        table->_bindings[idx] = -1;
+        for (size_t var = 0; var < program->_numOfVariables; ++var)
+        {
+            const char *name = program->_variables[var];
+            if (table->_columns[var] == NULL && strlen(name) == (size_t)(fieldEnd - field) && \
+                strncmp(name, field, fieldEnd - field) == 0)
+            {
+                table->_bindings[idx] = (long)var;
+                table->_columns[var] = (Value *)malloc(sizeof(Value) * FORMULA_BLOCK_ROWS);
+                if (table->_columns[var] == NULL)
+                {
+                    fprintf(stderr, "%s", MEM_SEG_ERR);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            }
+        }
+    }
+    for (size_t var = 0; var < program->_numOfVariables; ++var)
     {
-        //translates the exp to infix expression & prints exp in infix form:
-        size_t inSize = 0;
-        Token **infix = expToInfix(result, &inSize);
-        printExp("infix", infix, inSize);
+        if (table->_columns[var] == NULL)
+        {
+            fprintf(stderr, "%s", MISSING_COLUMN_ERR);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
 
-        //translates from infix to postfix & prints the exp in postfix form:
-        size_t postSize = 0;
-        Token** postfix = infixToPostfix(infix, inSize, &postSize);
-        printExp("postfix", postfix, postSize);
+/**
+ * frees the memory of the supplied table.
+ * @param table: a Table object.
+ * @param program: its formula.
+ */
+void freeTable(Table *table, const Program *program)
+{
+    for (size_t var = 0; var < program->_numOfVariables; ++var)
+    {
+        free(table->_columns[var]);
+    }
+    free(table->_columns);
+    free(table->_bindings);
+    free(table->_values);
+}
+
+/**
+ * evaluates the formula on the rows of the table, appends their values to the output, and
+ * empties the table.
+ * if the evaluation of a row fails: prints the values before it, prints an error and exits.
+ * @param table: a Table object.
+ * @param program: its formula.
+ * @param output: an Output object.
+ */
+void evaluateTable(Table *table, const Program *program, Output *output)
+{
+    size_t numOfValues;
+    const EvalStatus status = runProgramOnColumns(program, (const Value *const *)table->_columns, \
+                                                  table->_numOfRows, table->_values, &numOfValues);
+    for (size_t row = 0; row < numOfValues; ++row)
+    {
+        appendValue(output, table->_values[row]);
+    }
+    if (status != Eval_Succeed)
+    {
+        exitOnError(output, status);
+    }
+    table->_numOfRows = 0;
+}
 
-        deleteArrayOfTokens(infix, inSize); // restore memory
+/**
+ * adds a row of the input to the table (the table is evaluated first if it is full). an empty
+ * line is skipped.
+ * if the row doesn't have a field for every name of the header, or a field of a variable isn't
+ * an integer: evaluates the rows before it, prints an error and exits.
+ * @param table: a Table object.
+ * @param program: its formula.
+ * @param output: an Output object.
+ * @param line: the row.
+ * @param lineLen: the num of chars in <line>.
+ */
+void addRow(Table *table, const Program *program, Output *output, const char *line, \
+            const size_t lineLen)
+{
+    const char *const end = line + lineLen;
+    const char *fieldEnd = line;
+    if (nextField(fieldEnd, end, &fieldEnd) == fieldEnd)
+    {
+        return;
+    }
+    if (table->_numOfRows == FORMULA_BLOCK_ROWS)
+    {
+        evaluateTable(table, program, output);
+    }
+    size_t numOfFields = 0;
+    int isValid = 1;
+    fieldEnd = line;
+    const char *field;
+    while (isValid && (field = nextField(fieldEnd, end, &fieldEnd)) < fieldEnd)
+    {
+        isValid = numOfFields < table->_numOfFields;
+        const long var = isValid ? table->_bindings[numOfFields] : -1;
+        if (var >= 0)
+        {
+            isValid = parseValue(field, fieldEnd - field, &table->_columns[var][table->_numOfRows]);
+        }
+        ++numOfFields;
+    }
+    if (!isValid || numOfFields != table->_numOfFields)
+    {
+        evaluateTable(table, program, output);
+        flushOutput(output);
+        fprintf(stderr, "%s", INVALID_ROW_ERR);
+        exit(EXIT_FAILURE);
+    }
+    ++table->_numOfRows;
+}
+
+/**
+ * compiles a formula once, and evaluates it on every row of stdin: the first line is a header
+ * of the names of the fields of the rows, and every other line is a row of integers, which are
+ * the values of the variables of the fields' names. the fields are separated by spaces, tabs or
+ * commas. the rows are evaluated by blocks of columns (see runProgramOnColumns), and the output
+ * (the formula's infix & postfix forms, and the value of every row) is written as in runBatch.
+ * if the formula isn't valid, or the evaluation of a row fails: prints an error and exits.
+ * @param evaluator: the state of the evaluation (see Evaluator).
+ * @param output: an empty Output object (left empty).
+ * @param formula: string that holds the formula.
+ */
+void runFormula(Evaluator *evaluator, Output *output, const char *formula)
+{
+    const CachedProgram *entry = findExp(evaluator->_cache, evaluator->_arena, \
+                                         evaluator->_operators, formula, strlen(formula));
+    if (evaluator->_echo)
+    {
+        appendOutput(output, entry->_echo, strlen(entry->_echo));
+        flushOutput(output);
+    }
+    if (entry->_program == NULL)
+    {
+        fprintf(stderr, "%s", INVALID_EXP_ERR);
+        exit(EXIT_FAILURE);
+    }
+    size_t capacity = BATCH_READ_LEN, size = 0;
+    char *input = (char *)malloc(capacity);
+    if (input == NULL)
+    {
+        fprintf(stderr, "%s", MEM_SEG_ERR);
+        exit(EXIT_FAILURE);
+    }
+    Table table;
+    int isEof = 0, hasHeader = 0;
+    while (!isEof)
+    {
+        isEof = readBlock(&input, &size, &capacity);
+        // adds the complete lines, and keeps the rest for the next block:
+        const char *lineStart = input;
+        const char *const end = input + size;
+        const char *lineEnd;
+        while (lineStart < end)
+        {
+            lineEnd = memchr(lineStart, '\n', end - lineStart);
+            if (lineEnd == NULL && !isEof)
+            {
+                break;
+            }
+            lineEnd = (lineEnd == NULL) ? end : lineEnd; // the last line has no '\n'
+            if (hasHeader)
+            {
+                addRow(&table, entry->_program, output, lineStart, lineEnd - lineStart);
+            }
+            else
+            {
+                initTable(&table, entry->_program, lineStart, lineEnd - lineStart);
+                hasHeader = 1;
+            }
+            lineStart = (lineEnd < end) ? lineEnd + 1 : end;
+        }
+        size -= lineStart - input;
+        memmove(input, lineStart, size);
+    }
+    if (hasHeader)
+    {
+        evaluateTable(&table, entry->_program, output);
+        freeTable(&table, entry->_program);
+    }
+    flushOutput(output);
+    free(input);
+}
 
-        //evaluate the exp in postfix form & print the evaluation:
-        int evaluation = evaluateExp(postfix, postSize);
-        printf("The value is %d\n", evaluation);
+//------------------------RUN THE PROGRAM----------------------------------------------------------
 
-        deleteArrayOfTokens(postfix, postSize); //restore memory
+/**
+ * runs the program: evaluates every line of stdin (see in file description).
+ * @param argc: the number of the program's arguments
+ * @param argv: the program arguments: [--batch] [--quiet] [--threads=<n>] [--formula=<exp>].
+ *              with --batch the lines are read & written in big blocks, and they may be of any
+ *              length (see runBatch). otherwise lines longer than MAX_LINE_LEN are split. with
+ *              --threads=<n> (n > 0) the lines are evaluated in parallel by n workers (see
+ *              runPipeline), as in --batch. with --formula=<exp> the lines are rows of values of
+ *              the variables of <exp>, which is evaluated on each of them (see runFormula), and
+ *              --batch & --threads are ignored. with --quiet only the values are printed,
+ *              without the infix & postfix forms.
+ * @return: 0 i succeed, 1 otherwise.
+ */
+int main(int argc, char *argv[])
+{
+    int isBatch = 0, echo = 1;
+    long numOfWorkers = 0;
+    const char *formula = NULL;
+    for (int idx = 1; idx < argc; ++idx)
+    {
+        if (strcmp(argv[idx], BATCH_OPTION) == 0)
+        {
+            isBatch = 1;
+        }
+        else if (strcmp(argv[idx], QUIET_OPTION) == 0)
+        {
+            echo = 0;
+        }
+        else if (strncmp(argv[idx], THREADS_OPTION, strlen(THREADS_OPTION)) == 0)
+        {
+            char *remaining = NULL;
+            numOfWorkers = strtol(argv[idx] + strlen(THREADS_OPTION), &remaining, 10);
+            if (*remaining != '\0' || numOfWorkers <= 0)
+            {
+                fprintf(stderr, "%s", USAGE_ERR);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (strncmp(argv[idx], FORMULA_OPTION, strlen(FORMULA_OPTION)) == 0)
+        {
+            formula = argv[idx] + strlen(FORMULA_OPTION);
+        }
+        else
+        {
+            fprintf(stderr, "%s", USAGE_ERR);
+            return EXIT_FAILURE;
+        }
+    }
+    if (numOfWorkers > 0 && formula == NULL)
+    {
+        runPipeline((size_t)numOfWorkers, echo);
+        return 0;
+    }
+    char buff[MAX_LINE_LEN + 1]; //including '\n'
+    Evaluator evaluator;
+    Output output = {(char *)malloc(BATCH_WRITE_LEN), 0, BATCH_WRITE_LEN, STDOUT_FILENO, \
+                     NULL, 0, 0};
+    if (!initEvaluator(&evaluator, echo) || output._data == NULL)
+    {
+        return EXIT_FAILURE;
+    }
+    if (formula != NULL)
+    {
+        runFormula(&evaluator, &output, formula);
+    }
+    else if (isBatch)
+    {
+        runBatch(&evaluator, &output);
+    }
+    else
+    {
+        // reads infix expression as string from user:
+        char *result = fgets(buff, MAX_LINE_LEN + 1, stdin);
+        while (result != NULL)
+        {
+            //prints the exp in infix & postfix forms, & evaluates it:
+            const EvalStatus status = evaluateLine(&evaluator, &output, result, \
+                                                   strcspn(result, "\n"));
+            if (status != Eval_Succeed)
+            {
+                exitOnError(&output, status);
+            }
+            flushOutput(&output);
 
-        //reads next line from user:
-        result = fgets(buff, MAX_LINE_LEN + 1, stdin);
+            //reads next line from user:
+            result = fgets(buff, MAX_LINE_LEN + 1, stdin);
+        }
     }
+    free(output._data);
+    free(output._diagnostics);
+    freeEvaluator(&evaluator);
     return 0;
-}
\ No newline at end of file
+}
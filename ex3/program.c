@@ -0,0 +1,728 @@
+#include "program.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+/**
+ * the mark of a left parenthesis on the operator stack of evaluateDirect (which holds no pushes).
+ */
+#define PARENTHESIS_MARK Push_Op
+
+/**
+ * the precedence of every OpCode (as the precedence of its char in main.c).
+ */
+static const int PRECEDENCES[] = {-1, 1, 1, 2, 2, 3};
+
+/**
+ * @param operatorChar: char that is  '+' , '-', '/', '*', '^'.
+ * @return: the OpCode of the operator supplied.
+ *          if the supplied char is not an operator returns Push_Op.
+ */
+static OpCode parseOpCode(const char operatorChar)
+{
+    switch (operatorChar)
+    {
+        case '+':
+            return Add_Op;
+        case '-':
+            return Sub_Op;
+        case '*':
+            return Mul_Op;
+        case '/':
+            return Div_Op;
+        case '^':
+            return Pow_Op;
+        default:
+            return Push_Op;
+    }
+}
+
+/**
+ * @param digits: the digits of an operand (not necessarily followed by a non-digit).
+ * @param length: the num of digits.
+ * @param operand: receives the operand.
+ * @return 1 if succeed, 0 if the operand doesn't fit in a Value, -1 if <digits> holds a char
+ *         that isn't a digit (i.e. it isn't an operand at all).
+ */
+static int parseOperand(const char *digits, const size_t length, Value *operand)
+{
+    Value parsed = 0;
+    for (size_t idx = 0; idx < length; ++idx)
+    {
+        if (!isdigit(digits[idx]))
+        {
+            return -1;
+        }
+        if (__builtin_mul_overflow(parsed, 10, &parsed) || \
+            __builtin_add_overflow(parsed, digits[idx] - '0', &parsed))
+        {
+            return 0;
+        }
+    }
+    *operand = parsed;
+    return 1;
+}
+
+/**
+ * finds the index of a variable of the program, and adds it to the program's variables if it
+ * isn't one of them yet.
+ * @param program: a Program object (being compiled).
+ * @param name: the name of the variable (not necessarily followed by a '\0').
+ * @param length: the num of chars in <name>.
+ * @param index: receives the index of the variable.
+ * @return 1 if succeed, 0 if the memory allocation failed.
+ */
+static int findVariable(Program *program, const char *name, const size_t length, Value *index)
+{
+    for (size_t idx = 0; idx < program->_numOfVariables; ++idx)
+    {
+        const char *variable = program->_variables[idx];
+        if (strncmp(variable, name, length) == 0 && variable[length] == '\0')
+        {
+            *index = (Value)idx;
+            return 1;
+        }
+    }
+    char *variable = (char *)malloc(length + 1);
+    if (variable == NULL)
+    {
+        return 0;
+    }
+    memcpy(variable, name, length);
+    variable[length] = '\0';
+    *index = (Value)program->_numOfVariables;
+    program->_variables[program->_numOfVariables++] = variable;
+    return 1;
+}
+
+/**
+ * compiles an expression given in postfix form to bytecode.
+ * @param line: the line that holds the tokens.
+ * @param postfix: dynamic array that holds Token objects,
+ *               representing mathematical expression in postfix form.
+ * @param size: the number of elements in <postfix>.
+ * @return the program, or NULL if <postfix> isn't a valid expression or the memory allocation
+ *         failed.
+ */
+Program *compileProgram(const char *line, Token **postfix, const size_t size)
+{
+    Program *program = (Program *)malloc(sizeof(Program));
+    Instruction *code = (Instruction *)malloc(sizeof(Instruction) * (size + 1));
+    char **variables = (char **)malloc(sizeof(char *) * (size + 1));
+    if (program == NULL || code == NULL || variables == NULL)
+    {
+        fprintf(stderr, "%s", MEM_SEG_ERR);
+        free(program);
+        free(code);
+        free(variables);
+        return NULL;
+    }
+    program->_code = code;
+    program->_size = size;
+    program->_variables = variables;
+    program->_numOfVariables = 0;
+    size_t depth = 0;
+    for (size_t idx = 0; idx < size; ++idx)
+    {
+        const enum ArithmeticTokens type = getType(postfix[idx]);
+        if (type == Operand)
+        {
+            const int parsed = parseOperand(getData(postfix[idx], line), \
+                                            getLength(postfix[idx]), &code[idx]._operand);
+            if (parsed < 0) // not a number
+            {
+                depth = 0;
+                break;
+            }
+            code[idx]._op = parsed ? Push_Op : Overflow_Op;
+            ++depth;
+        }
+        else if (type == Variable)
+        {
+            code[idx]._op = Load_Op;
+            if (!findVariable(program, getData(postfix[idx], line), getLength(postfix[idx]), \
+                              &code[idx]._operand))
+            {
+                fprintf(stderr, "%s", MEM_SEG_ERR);
+                freeProgram(&program);
+                return NULL;
+            }
+            ++depth;
+        }
+        else
+        {
+            code[idx]._op = parseOpCode(*getData(postfix[idx], line));
+            code[idx]._operand = 0;
+            if (code[idx]._op == Push_Op || depth < 2) // not an operator, or missing operands
+            {
+                depth = 0;
+                break;
+            }
+            --depth;
+        }
+    }
+    if (depth != 1)
+    {
+        freeProgram(&program);
+        return NULL;
+    }
+    return program;
+}
+
+/**
+ * raises <base> to the power of <exponent> by squaring, in O(log(exponent)) multiplications.
+ * a negative exponent gives the integer part of the fraction, as the division does.
+ * @param base: a Value.
+ * @param exponent: a Value.
+ * @param value: receives <base> ^ <exponent>.
+ * @return Eval_Succeed, Eval_Overflow, or Eval_Division_By_Zero (0 ^ a negative exponent).
+ */
+static inline EvalStatus power(Value base, Value exponent, Value *value)
+{
+    if (exponent < 0)
+    {
+        if (base == 0)
+        {
+            return Eval_Division_By_Zero;
+        }
+        *value = (base == 1 || (base == -1 && exponent % 2 == 0)) ? 1 : (base == -1) ? -1 : 0;
+        return Eval_Succeed;
+    }
+    Value result = 1;
+    while (exponent > 0)
+    {
+        if ((exponent & 1) && __builtin_mul_overflow(result, base, &result))
+        {
+            return Eval_Overflow;
+        }
+        exponent >>= 1;
+        // (once the square overflows, so does the result of the remaining bits)
+        if (exponent > 0 && __builtin_mul_overflow(base, base, &base))
+        {
+            return Eval_Overflow;
+        }
+    }
+    *value = result;
+    return Eval_Succeed;
+}
+
+/**
+ * applies the supplied operator on 2 values, with overflow checks.
+ * @param op: an OpCode of an operator.
+ * @param a: the left value.
+ * @param b: the right value.
+ * @param value: receives the result of: <op>(<a>,<b>).
+ * @return Eval_Succeed, or the error of <op> (then <value> is not changed).
+ */
+static inline __attribute__((always_inline)) EvalStatus applyOperator(const OpCode op, \
+                                                                      const Value a, \
+                                                                      const Value b, Value *value)
+{
+    switch (op)
+    {
+        case Add_Op:
+            return __builtin_add_overflow(a, b, value) ? Eval_Overflow : Eval_Succeed;
+        case Sub_Op:
+            return __builtin_sub_overflow(a, b, value) ? Eval_Overflow : Eval_Succeed;
+        case Mul_Op:
+            return __builtin_mul_overflow(a, b, value) ? Eval_Overflow : Eval_Succeed;
+        case Div_Op:
+            if (b == 0)
+            {
+                return Eval_Division_By_Zero;
+            }
+            if (a == INT64_MIN && b == -1)
+            {
+                return Eval_Overflow;
+            }
+            *value = a / b;
+            return Eval_Succeed;
+        case Pow_Op:
+            return power(a, b, value);
+        default:
+            return Eval_Overflow;
+    }
+}
+
+/**
+ * initializes empty stacks (no memory is allocated until they outgrow their local buffers).
+ * @param stacks: an EvalStacks object.
+ */
+void initEvalStacks(EvalStacks *stacks)
+{
+    valueStackInit(&stacks->_values);
+    opCodeStackInit(&stacks->_operators);
+}
+
+/**
+ * frees the memory of the stacks, and leaves them empty.
+ * @param stacks: an EvalStacks object.
+ */
+void freeEvalStacks(EvalStacks *stacks)
+{
+    valueStackFree(&stacks->_values);
+    opCodeStackFree(&stacks->_operators);
+}
+
+/**
+ * evaluates the supplied program.
+ * @param program: a Program object.
+ * @param variables: the values of the program's variables (see Program), or NULL if it has none.
+ * @param stacks: the stacks to evaluate on (see EvalStacks).
+ * @param value: receives the evaluation's result.
+ * @return Eval_Succeed, or the error that stopped the evaluation (then <value> is not changed).
+ */
+EvalStatus runProgram(const Program *program, const Value *variables, EvalStacks *stacks, \
+                      Value *value)
+{
+    ValueStack *const values = &stacks->_values;
+    valueStackClear(values);
+    EvalStatus status = Eval_Succeed;
+    const Instruction *const end = program->_code + program->_size;
+    for (const Instruction *ip = program->_code; status == Eval_Succeed && ip < end; ++ip)
+    {
+        if (ip->_op == Push_Op || ip->_op == Load_Op)
+        {
+            const Value pushed = (ip->_op == Push_Op) ? ip->_operand : variables[ip->_operand];
+            if (!valueStackPush(values, pushed))
+            {
+                fprintf(stderr, "%s", MEM_SEG_ERR);
+                exit(EXIT_FAILURE);
+            }
+            continue;
+        }
+        if (ip->_op == Overflow_Op)
+        {
+            status = Eval_Overflow;
+            break;
+        }
+        const Value b = valueStackPop(values);
+        Value *const a = valueStackTop(values);
+        status = applyOperator(ip->_op, *a, b, a);
+    }
+    if (status == Eval_Succeed)
+    {
+        *value = *valueStackTop(values);
+    }
+    return status;
+}
+
+/**
+ * applies an operator on the COLUMN_BLOCK_LEN rows of a block: a[row] = a[row] <op> b[row].
+ * the loops run over whole blocks, and the loops of the addition and the subtraction detect
+ * overflows by the signs of the results (instead of a branch per row), so they are vectorized.
+ * @param op: an OpCode of an operator.
+ * @param a: the left operands of the rows (replaced by the results).
+ * @param b: the right operands of the rows.
+ * @return 1 if succeed, 0 if the operator fails (see EvalStatus) on a row (then <a> holds no
+ *         valid results).
+ */
+static int applyOnBlock(const OpCode op, Value *restrict a, const Value *restrict b)
+{
+    uint64_t overflows = 0;
+    int failed = 0;
+    switch (op)
+    {
+        case Add_Op:
+            for (size_t row = 0; row < COLUMN_BLOCK_LEN; ++row)
+            {
+                const uint64_t sum = (uint64_t)a[row] + (uint64_t)b[row];
+                overflows |= ((uint64_t)a[row] ^ sum) & ((uint64_t)b[row] ^ sum);
+                a[row] = (Value)sum;
+            }
+            return (overflows >> 63) == 0;
+        case Sub_Op:
+            for (size_t row = 0; row < COLUMN_BLOCK_LEN; ++row)
+            {
+                const uint64_t difference = (uint64_t)a[row] - (uint64_t)b[row];
+                overflows |= ((uint64_t)a[row] ^ (uint64_t)b[row]) & \
+                             ((uint64_t)a[row] ^ difference);
+                a[row] = (Value)difference;
+            }
+            return (overflows >> 63) == 0;
+        case Mul_Op:
+            for (size_t row = 0; row < COLUMN_BLOCK_LEN; ++row)
+            {
+                failed |= __builtin_mul_overflow(a[row], b[row], &a[row]);
+            }
+            return !failed;
+        case Div_Op:
+            for (size_t row = 0; row < COLUMN_BLOCK_LEN; ++row)
+            {
+                failed |= (b[row] == 0) | ((a[row] == INT64_MIN) & (b[row] == -1));
+            }
+            for (size_t row = 0; !failed && row < COLUMN_BLOCK_LEN; ++row)
+            {
+                a[row] /= b[row];
+            }
+            return !failed;
+        case Pow_Op:
+            for (size_t row = 0; row < COLUMN_BLOCK_LEN; ++row)
+            {
+                failed |= power(a[row], b[row], &a[row]) != Eval_Succeed;
+            }
+            return !failed;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * evaluates the supplied program on a block of rows (see runProgramOnColumns), with a stack of
+ * blocks of values. the variables of the rows after the last one (in a block that isn't full)
+ * are 1, so they could only fail the block, which is then evaluated again row by row.
+ * @param program: a Program object.
+ * @param columns: the column of the values of every variable of the program.
+ * @param first: the index of the first row of the block.
+ * @param numOfRows: the num of rows in the block.
+ * @param blocks: the stack, which has room for as many blocks of COLUMN_BLOCK_LEN values as the
+ *                program needs. receives the values of the rows in its first block.
+ * @return 1 if succeed, 0 if the evaluation of a row fails.
+ */
+static int runBlock(const Program *program, const Value *const *columns, const size_t first, \
+                    const size_t numOfRows, Value *blocks)
+{
+    Value *top = blocks; // the block above the top of the stack
+    const Instruction *const end = program->_code + program->_size;
+    for (const Instruction *ip = program->_code; ip < end; ++ip)
+    {
+        switch (ip->_op)
+        {
+            case Push_Op:
+                for (size_t row = 0; row < COLUMN_BLOCK_LEN; ++row)
+                {
+                    top[row] = ip->_operand;
+                }
+                top += COLUMN_BLOCK_LEN;
+                break;
+            case Load_Op:
+                memcpy(top, columns[ip->_operand] + first, sizeof(Value) * numOfRows);
+                for (size_t row = numOfRows; row < COLUMN_BLOCK_LEN; ++row)
+                {
+                    top[row] = 1;
+                }
+                top += COLUMN_BLOCK_LEN;
+                break;
+            case Overflow_Op:
+                return 0;
+            default:
+                top -= COLUMN_BLOCK_LEN;
+                if (!applyOnBlock(ip->_op, top - COLUMN_BLOCK_LEN, top))
+                {
+                    return 0;
+                }
+        }
+    }
+    return 1;
+}
+
+/**
+ * evaluates the supplied program on every row of a table of values of its variables, given by
+ * columns. every instruction is applied on a block of COLUMN_BLOCK_LEN rows at once (so the loop
+ * over the rows of an instruction can be vectorized), and a block in which a row fails is
+ * evaluated again row by row, to find the first failure.
+ * @param program: a Program object.
+ * @param columns: the column of the values of every variable of the program (see Program).
+ * @param numOfRows: the num of values in every column.
+ * @param values: receives the value of every row.
+ * @param numOfValues: receives the num of rows that were evaluated (all of them, or the rows
+ *                     before the first failure).
+ * @return Eval_Succeed, or the error that stopped the evaluation of a row.
+ */
+EvalStatus runProgramOnColumns(const Program *program, const Value *const *columns, \
+                               const size_t numOfRows, Value *values, size_t *numOfValues)
+{
+    size_t depth = 0, maxDepth = 0;
+    for (size_t idx = 0; idx < program->_size; ++idx)
+    {
+        const OpCode op = program->_code[idx]._op;
+        depth = (op == Push_Op || op == Load_Op || op == Overflow_Op) ? depth + 1 : depth - 1;
+        maxDepth = (depth > maxDepth) ? depth : maxDepth;
+    }
+    // the stack of runBlock, followed by the values of the variables of a row:
+    Value *blocks = (Value *)malloc(sizeof(Value) * \
+                                    (maxDepth * COLUMN_BLOCK_LEN + program->_numOfVariables));
+    if (blocks == NULL)
+    {
+        fprintf(stderr, "%s", MEM_SEG_ERR);
+        exit(EXIT_FAILURE);
+    }
+    Value *const variables = blocks + maxDepth * COLUMN_BLOCK_LEN;
+    EvalStacks stacks;
+    initEvalStacks(&stacks);
+    EvalStatus status = Eval_Succeed;
+    *numOfValues = 0;
+    for (size_t first = 0; status == Eval_Succeed && first < numOfRows; first += COLUMN_BLOCK_LEN)
+    {
+        const size_t blockLen = (numOfRows - first < COLUMN_BLOCK_LEN) ? numOfRows - first : \
+                                                                         COLUMN_BLOCK_LEN;
+        if (runBlock(program, columns, first, blockLen, blocks))
+        {
+            memcpy(values + first, blocks, sizeof(Value) * blockLen);
+            *numOfValues += blockLen;
+            continue;
+        }
+        for (size_t row = first; status == Eval_Succeed && row < first + blockLen; ++row)
+        {
+            for (size_t idx = 0; idx < program->_numOfVariables; ++idx)
+            {
+                variables[idx] = columns[idx][row];
+            }
+            status = runProgram(program, variables, &stacks, &values[row]);
+            *numOfValues += (status == Eval_Succeed);
+        }
+    }
+    freeEvalStacks(&stacks);
+    free(blocks);
+    return status;
+}
+
+/**
+ * applies the operator at the top of the operator stack of evaluateDirect on the 2 values at
+ * the top of its operand stack, and replaces them by the result.
+ * @param operands: the operand stack.
+ * @param operators: the operator stack (not empty).
+ * @return 1 if succeed, 0 if an operand is missing or the operator fails (see EvalStatus).
+ */
+static inline int reduce(ValueStack *operands, OpCodeStack *operators)
+{
+    if (valueStackSize(operands) < 2)
+    {
+        return 0;
+    }
+    const Value b = valueStackPop(operands);
+    Value *const a = valueStackTop(operands);
+    return applyOperator(opCodeStackPop(operators), *a, b, a) == Eval_Succeed;
+}
+
+/**
+ * the single pass of evaluateDirect over the chars of <exp>.
+ * @param exp: string that holds a mathematical expression.
+ * @param expLen: the num of chars in <exp>.
+ * @param operands: the operand stack.
+ * @param operators: the operator stack.
+ * @param value: receives the evaluation's result.
+ * @return as evaluateDirect.
+ */
+static int evaluateOnStacks(const char *exp, const size_t expLen, ValueStack *operands, \
+                            OpCodeStack *operators, Value *value)
+{
+    valueStackClear(operands);
+    opCodeStackClear(operators);
+    size_t idx = 0;
+    while (idx < expLen)
+    {
+        const char c = exp[idx];
+        if (isdigit(c))
+        {
+            const size_t start = idx;
+            while (idx < expLen && isdigit(exp[idx]))
+            {
+                ++idx;
+            }
+            Value operand;
+            if (parseOperand(exp + start, idx - start, &operand) != 1 || \
+                !valueStackPush(operands, operand))
+            {
+                return 0;
+            }
+            continue;
+        }
+        ++idx;
+        if (c == ')') // applies the operators back to the left parenthesis, and pops it
+        {
+            while (opCodeStackSize(operators) > 0 && *opCodeStackTop(operators) != PARENTHESIS_MARK)
+            {
+                if (!reduce(operands, operators))
+                {
+                    return 0;
+                }
+            }
+            if (opCodeStackSize(operators) > 0)
+            {
+                opCodeStackPop(operators);
+            }
+            continue;
+        }
+        const OpCode op = (c == '(') ? PARENTHESIS_MARK : parseOpCode(c);
+        if (op == PARENTHESIS_MARK && c != '(')
+        {
+            return 0;
+        }
+        while (op != PARENTHESIS_MARK && opCodeStackSize(operators) > 0 && \
+               *opCodeStackTop(operators) != PARENTHESIS_MARK && \
+               PRECEDENCES[op] <= PRECEDENCES[*opCodeStackTop(operators)])
+        {
+            if (!reduce(operands, operators))
+            {
+                return 0;
+            }
+        }
+        if (!opCodeStackPush(operators, op))
+        {
+            return 0;
+        }
+    }
+    while (opCodeStackSize(operators) > 0)
+    {
+        if (*opCodeStackTop(operators) == PARENTHESIS_MARK || !reduce(operands, operators))
+        {
+            return 0;
+        }
+    }
+    if (valueStackSize(operands) != 1)
+    {
+        return 0;
+    }
+    *value = *valueStackTop(operands);
+    return 1;
+}
+
+/**
+ * evaluates an expression given in infix form as string in a single pass over its chars, with
+ * an operand stack of Values and an operator stack of OpCodes (that are applied as soon as the
+ * shunting-yard algorithm would output them), without allocating memory (unless the expression
+ * is nested deeper than the stacks ever were, see EvalStacks).
+ * the result is the same as of compiling the expression (see compileProgram) and running it.
+ * @param exp: string that holds a mathematical expression.
+ * @param expLen: the num of chars in <exp>.
+ * @param stacks: the stacks to evaluate on (see EvalStacks).
+ * @param value: receives the evaluation's result.
+ * @return 1 if succeed, 0 if the expression isn't valid, fails (see EvalStatus) or has a char
+ *         that isn't a digit, an operator or a parenthesis (then <value> is not changed, and the
+ *         expression should be compiled to tell them apart).
+ */
+int evaluateDirect(const char *exp, const size_t expLen, EvalStacks *stacks, Value *value)
+{
+    return evaluateOnStacks(exp, expLen, &stacks->_values, &stacks->_operators, value);
+}
+
+/**
+ * deletes the program & frees the memory
+ * @param program: the address of a Program object.
+ */
+void freeProgram(Program **program)
+{
+    if (*program != NULL)
+    {
+        for (size_t idx = 0; idx < (*program)->_numOfVariables; ++idx)
+        {
+            free((*program)->_variables[idx]);
+        }
+        free((*program)->_variables);
+        free((*program)->_code);
+        free(*program);
+        *program = NULL;
+    }
+}
+
+/**
+ * @param text: the expression's text.
+ * @param textLen: the num of chars in <text>.
+ * @return the index of the entry of <text> in a ProgramCache (by the FNV-1a hash of <text>).
+ */
+static size_t cacheIndex(const char *text, const size_t textLen)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t idx = 0; idx < textLen; ++idx)
+    {
+        hash = (hash ^ (unsigned char)text[idx]) * 1099511628211ULL;
+    }
+    return (size_t)(hash % PROGRAM_CACHE_SIZE);
+}
+
+/**
+ * creates a new, empty, ProgramCache object.
+ * @return the cache, or NULL if the memory allocation failed.
+ */
+ProgramCache *cacheAlloc()
+{
+    ProgramCache *cache = (ProgramCache *)calloc(1, sizeof(ProgramCache));
+    if (cache == NULL)
+    {
+        fprintf(stderr, "%s", MEM_SEG_ERR);
+    }
+    return cache;
+}
+
+/**
+ * frees the fields of the supplied entry, and leaves it empty.
+ * @param entry: a CachedProgram object.
+ */
+static void clearEntry(CachedProgram *entry)
+{
+    free(entry->_text);
+    free(entry->_echo);
+    freeProgram(&entry->_program);
+    entry->_text = NULL;
+    entry->_echo = NULL;
+    entry->_textLen = 0;
+}
+
+/**
+ * @param cache: a ProgramCache object.
+ * @param text: the expression's text.
+ * @param textLen: the num of chars in <text>.
+ * @return the entry that holds the program of <text>, or NULL if it isn't in the cache.
+ */
+const CachedProgram *lookupProgram(const ProgramCache *cache, const char *text, \
+                                   const size_t textLen)
+{
+    const CachedProgram *entry = &cache->_entries[cacheIndex(text, textLen)];
+    if (entry->_text != NULL && entry->_textLen == textLen && \
+        memcmp(entry->_text, text, textLen) == 0)
+    {
+        return entry;
+    }
+    return NULL;
+}
+
+/**
+ * keeps the supplied program of <text> in the cache (instead of the one in its entry).
+ * the cache takes ownership of <program> and <echo>.
+ * @param cache: a ProgramCache object.
+ * @param text: the expression's text (copied).
+ * @param textLen: the num of chars in <text>.
+ * @param program: the compiled expression, or NULL if the expression isn't valid.
+ * @param echo: the text that is printed before the value of the expression (a malloc'd string).
+ * @return the entry that holds the program, or NULL if the memory allocation failed (then
+ *         <program> and <echo> are freed).
+ */
+const CachedProgram *storeProgram(ProgramCache *cache, const char *text, const size_t textLen, \
+                                  Program *program, char *echo)
+{
+    CachedProgram *entry = &cache->_entries[cacheIndex(text, textLen)];
+    clearEntry(entry);
+    entry->_text = (char *)malloc(textLen + 1);
+    if (entry->_text == NULL)
+    {
+        fprintf(stderr, "%s", MEM_SEG_ERR);
+        freeProgram(&program);
+        free(echo);
+        return NULL;
+    }
+    memcpy(entry->_text, text, textLen);
+    entry->_text[textLen] = '\0';
+    entry->_textLen = textLen;
+    entry->_program = program;
+    entry->_echo = echo;
+    return entry;
+}
+
+/**
+ * deletes the cache, along with all of its programs, & frees the memory
+ * @param cache: the address of a ProgramCache object.
+ */
+void freeCache(ProgramCache **cache)
+{
+    if (*cache != NULL)
+    {
+        for (size_t idx = 0; idx < PROGRAM_CACHE_SIZE; ++idx)
+        {
+            clearEntry(&(*cache)->_entries[idx]);
+        }
+        free(*cache);
+        *cache = NULL;
+    }
+}
@@ -0,0 +1,236 @@
+#ifndef PROGRAM_H
+#define PROGRAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "token.h"
+#include "stack.h"
+
+#define MEM_SEG_ERR "Error in memory allocation.\n"
+#define DIV_BY_ZERO_ERR "Division by 0!\n"
+#define OVERFLOW_ERR "Overflow!\n"
+
+/**
+ * the type of the values of the expressions.
+ */
+typedef int64_t Value;
+
+/**
+ * the num of rows that runProgramOnColumns applies every instruction on at once.
+ */
+#define COLUMN_BLOCK_LEN 256
+
+/**
+ * the num of entries of a ProgramCache.
+ */
+#define PROGRAM_CACHE_SIZE 4096
+
+/**
+ * holds the operations of the bytecode: pushing an operand, or applying an operator on the 2
+ * values at the top of the stack. Overflow_Op stands for an operand that doesn't fit in a Value,
+ * and Load_Op pushes the value of a variable.
+ */
+typedef enum OpCode
+{    Push_Op = 0,
+     Add_Op = 1,
+     Sub_Op = 2,
+     Mul_Op = 3,
+     Div_Op = 4,
+     Pow_Op = 5,
+     Overflow_Op = 6,
+     Load_Op = 7
+}OpCode;
+
+/**
+ * holds the results of an evaluation.
+ */
+typedef enum EvalStatus
+{    Eval_Succeed = 0,
+     Eval_Division_By_Zero = 1,
+     Eval_Overflow = 2
+}EvalStatus;
+
+/**
+ * the stack of the values of runProgram, and of the operands of evaluateDirect.
+ */
+DEFINE_TYPED_STACK(ValueStack, valueStack, Value)
+
+/**
+ * the stack of the operators of evaluateDirect.
+ */
+DEFINE_TYPED_STACK(OpCodeStack, opCodeStack, OpCode)
+
+/**
+ * a structure that represents the stacks that the evaluations run on which has 2 fields:
+ *    values: the stack of the values of runProgram, and of the operands of evaluateDirect.
+ *    operators: the stack of the operators of evaluateDirect.
+ * the stacks keep their buffers between evaluations, so the evaluations of a thread that reuses
+ * its stacks allocate only for a line that is nested deeper than all the lines before it.
+ */
+typedef struct EvalStacks
+{
+    ValueStack _values;
+    OpCodeStack _operators;
+}EvalStacks;
+
+/**
+ * a structure that represents an instruction of the bytecode which has 2 fields:
+ *    op: the operation.
+ *    operand: the parsed operand that Push_Op pushes, or the index of the variable that Load_Op
+ *             pushes (unused by the other operations).
+ */
+typedef struct Instruction
+{
+    OpCode _op;
+    Value _operand;
+}Instruction;
+
+/**
+ * a structure that represents a compiled expression which has 4 fields:
+ *    code: the instructions, in postfix order.
+ *    size: the num of instructions.
+ *    variables: the names of the variables of the expression (as strings), in the order of their
+ *               first appearance, which is the order of their values when it is evaluated.
+ *    numOfVariables: the num of variables.
+ */
+typedef struct Program
+{
+    Instruction *_code;
+    size_t _size;
+    char **_variables;
+    size_t _numOfVariables;
+}Program;
+
+/**
+ * a structure that represents an entry of a ProgramCache which has 4 fields:
+ *    text: the expression's text (a copy of it).
+ *    textLen: the num of chars in text.
+ *    program: the compiled expression (NULL if the expression isn't valid).
+ *    echo: the text that is printed before the value of the expression.
+ */
+typedef struct CachedProgram
+{
+    char *_text;
+    size_t _textLen;
+    Program *_program;
+    char *_echo;
+}CachedProgram;
+
+/**
+ * a structure that represents a cache of compiled expressions, keyed on their text. every text
+ * has a single entry it can be kept in (by its hash), which a new text replaces, so the cache's
+ * size is bounded and both lookups and stores are O(1).
+ */
+typedef struct ProgramCache
+{
+    CachedProgram _entries[PROGRAM_CACHE_SIZE];
+}ProgramCache;
+
+/**
+ * compiles an expression given in postfix form to bytecode.
+ * @param line: the line that holds the tokens.
+ * @param postfix: dynamic array that holds Token objects,
+ *               representing mathematical expression in postfix form.
+ * @param size: the number of elements in <postfix>.
+ * @return the program, or NULL if <postfix> isn't a valid expression or the memory allocation
+ *         failed.
+ */
+Program *compileProgram(const char *line, Token **postfix, const size_t size);
+
+/**
+ * initializes empty stacks (no memory is allocated until they outgrow their local buffers).
+ * @param stacks: an EvalStacks object.
+ */
+void initEvalStacks(EvalStacks *stacks);
+
+/**
+ * frees the memory of the stacks, and leaves them empty.
+ * @param stacks: an EvalStacks object.
+ */
+void freeEvalStacks(EvalStacks *stacks);
+
+/**
+ * evaluates the supplied program.
+ * @param program: a Program object.
+ * @param variables: the values of the program's variables (see Program), or NULL if it has none.
+ * @param stacks: the stacks to evaluate on (see EvalStacks).
+ * @param value: receives the evaluation's result.
+ * @return Eval_Succeed, or the error that stopped the evaluation (then <value> is not changed).
+ */
+EvalStatus runProgram(const Program *program, const Value *variables, EvalStacks *stacks, \
+                      Value *value);
+
+/**
+ * evaluates the supplied program on every row of a table of values of its variables, given by
+ * columns. every instruction is applied on a block of COLUMN_BLOCK_LEN rows at once (so the loop
+ * over the rows of an instruction can be vectorized), and a block in which a row fails is
+ * evaluated again row by row, to find the first failure.
+ * @param program: a Program object.
+ * @param columns: the column of the values of every variable of the program (see Program).
+ * @param numOfRows: the num of values in every column.
+ * @param values: receives the value of every row.
+ * @param numOfValues: receives the num of rows that were evaluated (all of them, or the rows
+ *                     before the first failure).
+ * @return Eval_Succeed, or the error that stopped the evaluation of a row.
+ */
+EvalStatus runProgramOnColumns(const Program *program, const Value *const *columns, \
+                               const size_t numOfRows, Value *values, size_t *numOfValues);
+
+/**
+ * evaluates an expression given in infix form as string in a single pass over its chars, with
+ * an operand stack of Values and an operator stack of OpCodes (that are applied as soon as the
+ * shunting-yard algorithm would output them), without allocating memory (unless the expression
+ * is nested deeper than the stacks ever were, see EvalStacks).
+ * the result is the same as of compiling the expression (see compileProgram) and running it.
+ * @param exp: string that holds a mathematical expression.
+ * @param expLen: the num of chars in <exp>.
+ * @param stacks: the stacks to evaluate on (see EvalStacks).
+ * @param value: receives the evaluation's result.
+ * @return 1 if succeed, 0 if the expression isn't valid, fails (see EvalStatus) or has a char
+ *         that isn't a digit, an operator or a parenthesis (then <value> is not changed, and the
+ *         expression should be compiled to tell them apart).
+ */
+int evaluateDirect(const char *exp, const size_t expLen, EvalStacks *stacks, Value *value);
+
+/**
+ * deletes the program & frees the memory
+ * @param program: the address of a Program object.
+ */
+void freeProgram(Program **program);
+
+/**
+ * creates a new, empty, ProgramCache object.
+ * @return the cache, or NULL if the memory allocation failed.
+ */
+ProgramCache *cacheAlloc();
+
+/**
+ * @param cache: a ProgramCache object.
+ * @param text: the expression's text.
+ * @param textLen: the num of chars in <text>.
+ * @return the entry that holds the program of <text>, or NULL if it isn't in the cache.
+ */
+const CachedProgram *lookupProgram(const ProgramCache *cache, const char *text, \
+                                   const size_t textLen);
+
+/**
+ * keeps the supplied program of <text> in the cache (instead of the one in its entry).
+ * the cache takes ownership of <program> and <echo>.
+ * @param cache: a ProgramCache object.
+ * @param text: the expression's text (copied).
+ * @param textLen: the num of chars in <text>.
+ * @param program: the compiled expression, or NULL if the expression isn't valid.
+ * @param echo: the text that is printed before the value of the expression (a malloc'd string).
+ * @return the entry that holds the program, or NULL if the memory allocation failed (then
+ *         <program> and <echo> are freed).
+ */
+const CachedProgram *storeProgram(ProgramCache *cache, const char *text, const size_t textLen, \
+                                  Program *program, char *echo);
+
+/**
+ * deletes the cache, along with all of its programs, & frees the memory
+ * @param cache: the address of a ProgramCache object.
+ */
+void freeCache(ProgramCache **cache);
+
+#endif //PROGRAM_H
@@ -0,0 +1,410 @@
+#include "queue.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <sched.h>
+#include <assert.h>
+
+/**
+ * @param capacity : a num of elements.
+ * @return : the smallest power of 2 that is capacity at least.
+ */
+static size_t roundCapacity(size_t capacity)
+{
+    size_t rounded = 2;
+    while (rounded < capacity)
+    {
+        rounded *= 2;
+    }
+    return rounded;
+}
+
+/**
+ * initializes the signal of a new queue (see QueueSignal).
+ * @param signal : the signal.
+ * @return : 1 if succeed, 0 otherwise.
+ */
+static int initSignal(QueueSignal* signal)
+{
+    atomic_init(&signal->_version, 0);
+    atomic_init(&signal->_waiters, 0);
+    if (pthread_mutex_init(&signal->_lock, NULL) != 0)
+    {
+        return 0;
+    }
+    if (pthread_cond_init(&signal->_changed, NULL) != 0)
+    {
+        pthread_mutex_destroy(&signal->_lock);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @param signal : a signal initialized by initSignal.
+ */
+static void destroySignal(QueueSignal* signal)
+{
+    pthread_mutex_destroy(&signal->_lock);
+    pthread_cond_destroy(&signal->_changed);
+}
+
+/**
+ * publishes a push (or a pop) of the queue, and wakes the threads that sleep on it, if any.
+ * (the version is bumped before the waiters are counted, and a waiter is counted before it reads
+ * the version (all seq_cst), so either the waiter sees the new version, or it is woken)
+ * @param signal : the signal of the queue.
+ */
+static void notifyChange(QueueSignal* signal)
+{
+    atomic_fetch_add(&signal->_version, 1);
+    if (atomic_load(&signal->_waiters) > 0)
+    {
+        pthread_mutex_lock(&signal->_lock);
+        pthread_cond_broadcast(&signal->_changed);
+        pthread_mutex_unlock(&signal->_lock);
+    }
+}
+
+/**
+ * counts a thread that is about to sleep on the queue: it has to retry its push (pop) after
+ * this, and then either cancelWait (if the retry succeeds) or awaitChange.
+ * @param signal : the signal of the queue.
+ * @return : the version to wait for the change of.
+ */
+static size_t prepareWait(QueueSignal* signal)
+{
+    atomic_fetch_add(&signal->_waiters, 1);
+    return atomic_load(&signal->_version);
+}
+
+/**
+ * @param signal : the signal of the queue (after prepareWait).
+ */
+static void cancelWait(QueueSignal* signal)
+{
+    atomic_fetch_sub(&signal->_waiters, 1);
+}
+
+/**
+ * sleeps until the queue changes (after prepareWait).
+ * @param signal : the signal of the queue.
+ * @param version : the version prepareWait returned.
+ */
+static void awaitChange(QueueSignal* signal, const size_t version)
+{
+    pthread_mutex_lock(&signal->_lock);
+    while (atomic_load(&signal->_version) == version)
+    {
+        pthread_cond_wait(&signal->_changed, &signal->_lock);
+    }
+    pthread_mutex_unlock(&signal->_lock);
+    atomic_fetch_sub(&signal->_waiters, 1);
+}
+
+/**
+ * creates a new MpmcQueue object
+ * @param capacity : the minimal num of elements the queue holds (rounded up to a power of 2).
+ * @return : the queue, or NULL if the memory allocation failed.
+ */
+MpmcQueue* mpmcAlloc(size_t capacity)
+{
+    capacity = roundCapacity(capacity);
+    MpmcQueue* queue = (MpmcQueue*)malloc(sizeof(MpmcQueue));
+    if (queue != NULL)
+    {
+        queue->_cells = (QueueCell*)malloc(capacity * sizeof(QueueCell));
+        if (queue->_cells != NULL && initSignal(&queue->_signal))
+        {
+            for (size_t idx = 0; idx < capacity; ++idx)
+            {
+                atomic_init(&queue->_cells[idx]._sequence, idx);
+            }
+            queue->_mask = capacity - 1;
+            atomic_init(&queue->_enqueuePos, 0);
+            atomic_init(&queue->_dequeuePos, 0);
+            return queue;
+        }
+        free(queue->_cells);
+        free(queue);
+    }
+    fprintf(stderr, "%s", MEM_SEG_ERR);
+    return NULL;
+}
+
+/**
+ * pushes the supplied element, unless the queue is full.
+ * a cell is free for the push of ticket t when its sequence is t (and is published by setting it
+ * to t + 1), so a sequence behind the ticket means the consumers didn't pop the cell of the
+ * previous round yet.
+ * @param queue : an MpmcQueue object
+ * @param data : the element.
+ * @return : 1 if it was pushed, 0 if the queue is full.
+ */
+int mpmcTryPush(MpmcQueue* queue, void *data)
+{
+    assert(queue != NULL);
+    size_t pos = atomic_load_explicit(&queue->_enqueuePos, memory_order_relaxed);
+    for (;;)
+    {
+        QueueCell* cell = &queue->_cells[pos & queue->_mask];
+        const size_t sequence = atomic_load_explicit(&cell->_sequence, memory_order_acquire);
+        if (sequence == pos)
+        {
+            if (atomic_compare_exchange_weak_explicit(&queue->_enqueuePos, &pos, pos + 1, \
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                cell->_data = data;
+                atomic_store_explicit(&cell->_sequence, pos + 1, memory_order_release);
+                notifyChange(&queue->_signal);
+                return 1;
+            }
+        }
+        else if ((ptrdiff_t)(sequence - pos) < 0)
+        {
+            return 0;
+        }
+        else
+        {
+            pos = atomic_load_explicit(&queue->_enqueuePos, memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * pops the first element, unless the queue is empty.
+ * a cell is full for the pop of ticket t when its sequence is t + 1 (and is freed for the next
+ * round by setting it to t + capacity).
+ * @param queue : an MpmcQueue object
+ * @param data : receives the element.
+ * @return : 1 if it was popped, 0 if the queue is empty.
+ */
+int mpmcTryPop(MpmcQueue* queue, void **data)
+{
+    assert(queue != NULL);
+    size_t pos = atomic_load_explicit(&queue->_dequeuePos, memory_order_relaxed);
+    for (;;)
+    {
+        QueueCell* cell = &queue->_cells[pos & queue->_mask];
+        const size_t sequence = atomic_load_explicit(&cell->_sequence, memory_order_acquire);
+        if (sequence == pos + 1)
+        {
+            if (atomic_compare_exchange_weak_explicit(&queue->_dequeuePos, &pos, pos + 1, \
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                *data = cell->_data;
+                atomic_store_explicit(&cell->_sequence, pos + queue->_mask + 1, \
+                                      memory_order_release);
+                notifyChange(&queue->_signal);
+                return 1;
+            }
+        }
+        else if ((ptrdiff_t)(sequence - (pos + 1)) < 0)
+        {
+            return 0;
+        }
+        else
+        {
+            pos = atomic_load_explicit(&queue->_dequeuePos, memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * pushes the supplied element, and waits while the queue is full: spins QUEUE_SPINS times
+ * (yielding the cpu), and then sleeps until a pop.
+ * @param queue : an MpmcQueue object
+ * @param data : the element.
+ */
+void mpmcPush(MpmcQueue* queue, void *data)
+{
+    for (size_t spins = 0; !mpmcTryPush(queue, data); ++spins)
+    {
+        if (spins < QUEUE_SPINS)
+        {
+            sched_yield();
+            continue;
+        }
+        const size_t version = prepareWait(&queue->_signal);
+        if (mpmcTryPush(queue, data))
+        {
+            cancelWait(&queue->_signal);
+            return;
+        }
+        awaitChange(&queue->_signal, version);
+    }
+}
+
+/**
+ * pops the first element, and waits while the queue is empty: spins QUEUE_SPINS times (yielding
+ * the cpu), and then sleeps until a push.
+ * @param queue : an MpmcQueue object
+ * @return : the element.
+ */
+void* mpmcPop(MpmcQueue* queue)
+{
+    void* data;
+    for (size_t spins = 0; !mpmcTryPop(queue, &data); ++spins)
+    {
+        if (spins < QUEUE_SPINS)
+        {
+            sched_yield();
+            continue;
+        }
+        const size_t version = prepareWait(&queue->_signal);
+        if (mpmcTryPop(queue, &data))
+        {
+            cancelWait(&queue->_signal);
+            break;
+        }
+        awaitChange(&queue->_signal, version);
+    }
+    return data;
+}
+
+/**
+ * deletes the queue & frees the memory (not of its elements)
+ * @param queue: the address of an MpmcQueue object
+ */
+void freeMpmc(MpmcQueue** queue)
+{
+    if (*queue != NULL)
+    {
+        destroySignal(&(*queue)->_signal);
+        free((*queue)->_cells);
+        free(*queue);
+        *queue = NULL;
+    }
+}
+
+/**
+ * creates a new SpscQueue object
+ * @param capacity : the minimal num of elements the queue holds (rounded up to a power of 2).
+ * @return : the queue, or NULL if the memory allocation failed.
+ */
+SpscQueue* spscAlloc(size_t capacity)
+{
+    capacity = roundCapacity(capacity);
+    SpscQueue* queue = (SpscQueue*)malloc(sizeof(SpscQueue));
+    if (queue != NULL)
+    {
+        queue->_slots = (void**)malloc(capacity * sizeof(void*));
+        if (queue->_slots != NULL && initSignal(&queue->_signal))
+        {
+            queue->_mask = capacity - 1;
+            atomic_init(&queue->_head, 0);
+            atomic_init(&queue->_tail, 0);
+            return queue;
+        }
+        free(queue->_slots);
+        free(queue);
+    }
+    fprintf(stderr, "%s", MEM_SEG_ERR);
+    return NULL;
+}
+
+/**
+ * pushes the supplied element, unless the queue is full. only a single thread may push.
+ * @param queue : an SpscQueue object
+ * @param data : the element.
+ * @return : 1 if it was pushed, 0 if the queue is full.
+ */
+int spscTryPush(SpscQueue* queue, void *data)
+{
+    assert(queue != NULL);
+    const size_t tail = atomic_load_explicit(&queue->_tail, memory_order_relaxed);
+    if (tail - atomic_load_explicit(&queue->_head, memory_order_acquire) > queue->_mask)
+    {
+        return 0;
+    }
+    queue->_slots[tail & queue->_mask] = data;
+    atomic_store_explicit(&queue->_tail, tail + 1, memory_order_release);
+    notifyChange(&queue->_signal);
+    return 1;
+}
+
+/**
+ * pops the first element, unless the queue is empty. only a single thread may pop.
+ * @param queue : an SpscQueue object
+ * @param data : receives the element.
+ * @return : 1 if it was popped, 0 if the queue is empty.
+ */
+int spscTryPop(SpscQueue* queue, void **data)
+{
+    assert(queue != NULL);
+    const size_t head = atomic_load_explicit(&queue->_head, memory_order_relaxed);
+    if (head == atomic_load_explicit(&queue->_tail, memory_order_acquire))
+    {
+        return 0;
+    }
+    *data = queue->_slots[head & queue->_mask];
+    atomic_store_explicit(&queue->_head, head + 1, memory_order_release);
+    notifyChange(&queue->_signal);
+    return 1;
+}
+
+/**
+ * pushes the supplied element, and waits while the queue is full (as mpmcPush).
+ * only a single thread may push.
+ * @param queue : an SpscQueue object
+ * @param data : the element.
+ */
+void spscPush(SpscQueue* queue, void *data)
+{
+    for (size_t spins = 0; !spscTryPush(queue, data); ++spins)
+    {
+        if (spins < QUEUE_SPINS)
+        {
+            sched_yield();
+            continue;
+        }
+        const size_t version = prepareWait(&queue->_signal);
+        if (spscTryPush(queue, data))
+        {
+            cancelWait(&queue->_signal);
+            return;
+        }
+        awaitChange(&queue->_signal, version);
+    }
+}
+
+/**
+ * pops the first element, and waits while the queue is empty (as mpmcPop).
+ * only a single thread may pop.
+ * @param queue : an SpscQueue object
+ * @return : the element.
+ */
+void* spscPop(SpscQueue* queue)
+{
+    void* data;
+    for (size_t spins = 0; !spscTryPop(queue, &data); ++spins)
+    {
+        if (spins < QUEUE_SPINS)
+        {
+            sched_yield();
+            continue;
+        }
+        const size_t version = prepareWait(&queue->_signal);
+        if (spscTryPop(queue, &data))
+        {
+            cancelWait(&queue->_signal);
+            break;
+        }
+        awaitChange(&queue->_signal, version);
+    }
+    return data;
+}
+
+/**
+ * deletes the queue & frees the memory (not of its elements)
+ * @param queue: the address of an SpscQueue object
+ */
+void freeSpsc(SpscQueue** queue)
+{
+    if (*queue != NULL)
+    {
+        destroySignal(&(*queue)->_signal);
+        free((*queue)->_slots);
+        free(*queue);
+        *queue = NULL;
+    }
+}
@@ -0,0 +1,180 @@
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#define MEM_SEG_ERR "Error in memory allocation.\n"
+
+/**
+ * the num of bytes of a cache line: the indices that different threads update are kept in
+ * different cache lines, so they don't invalidate each other's.
+ */
+#define CACHE_LINE_LEN 64
+
+/**
+ * the num of times that a blocking push (pop) retries, yielding the cpu in between, before it
+ * sleeps until the queue changes (see QueueSignal).
+ */
+#define QUEUE_SPINS 64
+
+/**
+ * represents the sleeps of the threads that wait on a queue (for an element to pop, or a cell to
+ * push to) with the fields:
+ * lock, changed: the threads sleep on <changed> (with <lock>) until the version changes.
+ * version: the num of pushes & pops of the queue so far.
+ * waiters: the num of threads that sleep (or are about to), so the pushes & pops lock & signal
+ *          only when there are any.
+ */
+typedef struct QueueSignal
+{
+  pthread_mutex_t _lock;
+  pthread_cond_t _changed;
+  atomic_size_t _version;
+  atomic_size_t _waiters;
+} QueueSignal;
+
+/**
+ * represents a cell of an MpmcQueue with the fields:
+ * sequence: the ticket of the push (or the pop) that the cell waits for (see mpmcTryPush).
+ * data: the pushed element.
+ */
+typedef struct QueueCell
+{
+  atomic_size_t _sequence;
+  void * _data;
+} QueueCell;
+
+/**
+ * represents a bounded, lock-free, multi-producer multi-consumer queue of pointers (D. Vyukov's)
+ * with the fields:
+ * cells: a ring of <mask> + 1 cells (a power of 2).
+ * enqueuePos: the ticket of the next push.
+ * dequeuePos: the ticket of the next pop.
+ * a producer (consumer) claims a ticket by a CAS on the position, and then owns the cell of the
+ * ticket until it publishes it, by its sequence.
+ * signal: the sleeps of the blocking pushes & pops (see mpmcPush).
+ */
+typedef struct MpmcQueue
+{
+  QueueCell * _cells;
+  size_t _mask;
+  char _pad1[CACHE_LINE_LEN];
+  atomic_size_t _enqueuePos;
+  char _pad2[CACHE_LINE_LEN];
+  atomic_size_t _dequeuePos;
+  char _pad3[CACHE_LINE_LEN];
+  QueueSignal _signal;
+} MpmcQueue;
+
+/**
+ * represents a bounded, lock-free, single-producer single-consumer queue of pointers with the
+ * fields:
+ * slots: a ring of <mask> + 1 slots (a power of 2).
+ * head: the num of pops so far (only the consumer writes it).
+ * tail: the num of pushes so far (only the producer writes it).
+ * signal: the sleeps of the blocking pushes & pops (see spscPush).
+ */
+typedef struct SpscQueue
+{
+  void ** _slots;
+  size_t _mask;
+  char _pad1[CACHE_LINE_LEN];
+  atomic_size_t _head;
+  char _pad2[CACHE_LINE_LEN];
+  atomic_size_t _tail;
+  char _pad3[CACHE_LINE_LEN];
+  QueueSignal _signal;
+} SpscQueue;
+
+/**
+ * creates a new MpmcQueue object
+ * @param capacity : the minimal num of elements the queue holds (rounded up to a power of 2).
+ * @return : the queue, or NULL if the memory allocation failed.
+ */
+MpmcQueue* mpmcAlloc(size_t capacity);
+
+/**
+ * pushes the supplied element, unless the queue is full.
+ * @param queue : an MpmcQueue object
+ * @param data : the element.
+ * @return : 1 if it was pushed, 0 if the queue is full.
+ */
+int mpmcTryPush(MpmcQueue* queue, void *data);
+
+/**
+ * pops the first element, unless the queue is empty.
+ * @param queue : an MpmcQueue object
+ * @param data : receives the element.
+ * @return : 1 if it was popped, 0 if the queue is empty.
+ */
+int mpmcTryPop(MpmcQueue* queue, void **data);
+
+/**
+ * pushes the supplied element, and waits while the queue is full: spins QUEUE_SPINS times
+ * (yielding the cpu), and then sleeps until a pop.
+ * @param queue : an MpmcQueue object
+ * @param data : the element.
+ */
+void mpmcPush(MpmcQueue* queue, void *data);
+
+/**
+ * pops the first element, and waits while the queue is empty: spins QUEUE_SPINS times (yielding
+ * the cpu), and then sleeps until a push.
+ * @param queue : an MpmcQueue object
+ * @return : the element.
+ */
+void* mpmcPop(MpmcQueue* queue);
+
+/**
+ * deletes the queue & frees the memory (not of its elements)
+ * @param queue: the address of an MpmcQueue object
+ */
+void freeMpmc(MpmcQueue** queue);
+
+/**
+ * creates a new SpscQueue object
+ * @param capacity : the minimal num of elements the queue holds (rounded up to a power of 2).
+ * @return : the queue, or NULL if the memory allocation failed.
+ */
+SpscQueue* spscAlloc(size_t capacity);
+
+/**
+ * pushes the supplied element, unless the queue is full. only a single thread may push.
+ * @param queue : an SpscQueue object
+ * @param data : the element.
+ * @return : 1 if it was pushed, 0 if the queue is full.
+ */
+int spscTryPush(SpscQueue* queue, void *data);
+
+/**
+ * pops the first element, unless the queue is empty. only a single thread may pop.
+ * @param queue : an SpscQueue object
+ * @param data : receives the element.
+ * @return : 1 if it was popped, 0 if the queue is empty.
+ */
+int spscTryPop(SpscQueue* queue, void **data);
+
+/**
+ * pushes the supplied element, and waits while the queue is full (as mpmcPush).
+ * only a single thread may push.
+ * @param queue : an SpscQueue object
+ * @param data : the element.
+ */
+void spscPush(SpscQueue* queue, void *data);
+
+/**
+ * pops the first element, and waits while the queue is empty (as mpmcPop).
+ * only a single thread may pop.
+ * @param queue : an SpscQueue object
+ * @return : the element.
+ */
+void* spscPop(SpscQueue* queue);
+
+/**
+ * deletes the queue & frees the memory (not of its elements)
+ * @param queue: the address of an SpscQueue object
+ */
+void freeSpsc(SpscQueue** queue);
+
+#endif //QUEUE_H
@@ -6,14 +6,25 @@
 /**
  * creates a new Stack object
  * @param elementSize : sizeof() the elements that this stack holds
- * @return : the stack
+ * @return : the stack, or NULL if the memory allocation failed.
  */
 Stack* stackAlloc(size_t elementSize)
 {
     Stack* stack = (Stack*)malloc(sizeof(Stack));
-    stack->_top = NULL;
-    stack->_elementSize = elementSize;
-    return stack;
+    if (stack != NULL)
+    {
+        stack->_data = malloc(STACK_INITIAL_CAPACITY * elementSize);
+        if (stack->_data != NULL)
+        {
+            stack->_size = 0;
+            stack->_capacity = STACK_INITIAL_CAPACITY;
+            stack->_elementSize = elementSize;
+            return stack;
+        }
+        free(stack);
+    }
+    fprintf(stderr, "%s", MEM_SEG_ERR);
+    return NULL;
 }
 
 /**
@@ -22,42 +33,36 @@ Stack* stackAlloc(size_t elementSize)
  */
 void freeStack(Stack** stack)
 {
-    Node* p1;
-    Node* p2;
     if (*stack != NULL)
     {
-        p1 = (*stack)->_top;
-        while(p1)
-        {
-            p2 = p1;
-            p1 = p1->_next;
-            free(p2->_data);
-            free(p2);
-        }
+        free((*stack)->_data);
         free(*stack);
         *stack = NULL;
     }
 }
 
 /**
- * pushes the supplied data onto the given stack
+ * pushes the supplied data onto the given stack.
+ * if the buffer can't grow, prints an error and returns, the stack is not changed.
  * @param stack : a Stack object
  * @param data : address of a data var with type consistent in size to _elementSize
  */
 void push(Stack* stack, void *data)
 {
-    Node *node = (Node *) malloc(sizeof(Node));
-    if (node != NULL)
+    assert(stack != NULL);
+    if (stack->_size == stack->_capacity)
     {
-        node->_data = malloc(stack->_elementSize);
-        if (node->_data != NULL)
+        void *grown = realloc(stack->_data, 2 * stack->_capacity * stack->_elementSize);
+        if (grown == NULL)
         {
-            memcpy(node->_data, data, stack->_elementSize);
-            node->_next = stack->_top;
-            stack->_top = node;
+            fprintf(stderr, "%s", MEM_SEG_ERR);
+            return;
         }
+        stack->_data = grown;
+        stack->_capacity *= 2;
     }
-    printf("%s", MEM_SEG_ERR);
+    memcpy((char *)stack->_data + stack->_size * stack->_elementSize, data, stack->_elementSize);
+    ++stack->_size;
 }
 
 /**
@@ -69,42 +74,37 @@ void push(Stack* stack, void *data)
 void pop(Stack* stack, void *headData) 
 {
     assert(stack != NULL);
-    if(stack->_top == NULL)
+    if(stack->_size == 0)
     {
         fprintf(stderr, "The stack is empty\n");
         return;
     }
-    Node *node = stack->_top;
-    memcpy(headData, node->_data, stack->_elementSize);
-    stack->_top = node->_next;
-    free(node->_data);
-    free(node);
+    --stack->_size;
+    memcpy(headData, (char *)stack->_data + stack->_size * stack->_elementSize, \
+           stack->_elementSize);
 }
 
 /**
  * @param stack : stack object
- * @return 0 if the stack isn't empty, 0 otherwise.
+ * @return 1 if the stack is empty, 0 otherwise.
  */
 int isEmptyStack(Stack* stack) 
 {
     assert(stack != NULL);
-    return stack->_top == NULL;
+    return stack->_size == 0;
 }
 
 /**
  * @param stack a Stack object.
- * @return pointer containing the stack's top data.
- * notice! free this after calling.
+ * @return pointer to the stack's top data (inside the stack's buffer, so don't free it), or NULL
+ *         if the stack is empty. notice! it is valid until the next push or pop.
  */
 void* peek(Stack *stack)
 {
     assert(stack != NULL);
-    if(stack->_top != NULL)
+    if(stack->_size != 0)
     {
-        Node *node = stack->_top;
-        char *topData = (char *)malloc(stack->_elementSize + 1);
-        memcpy(topData, node->_data, stack->_elementSize);
-        return topData;
+        return (char *)stack->_data + (stack->_size - 1) * stack->_elementSize;
     }
     fprintf(stderr, "The stack is empty\n");
     return NULL;
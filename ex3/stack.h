@@ -2,34 +2,35 @@
 #define STACK_H
 
 #include <stdlib.h>
+#include <string.h>
 #define MEM_SEG_ERR "Error in memory allocation.\n"
 
 /**
- * represents a node with the fields:
- * data: address to the data this Node holds. (void * enables generics)
- * next: the address of the next Node.
+ * the num of elements that a new Stack has room for, before its buffer grows.
  */
-typedef struct Node
-{
-  void * _data; // pointer to anything
-  struct Node * _next;
-} Node;
+#define STACK_INITIAL_CAPACITY 16
 
 /**
  * represents a Stack with the fields:
- * top: address of the top Node.
+ * data: a contiguous buffer of <capacity> elements, whose first <size> elements are the stack's
+ *       elements (the top is the last of them). (void * enables generics)
+ * size: the num of elements in the stack.
+ * capacity: the num of elements the buffer has room for. it doubles when the buffer is full, so a
+ *           push is O(1) amortized, and no memory is allocated per element.
  * element size: size of the elements this stack holds. (enables generics)
  */
 typedef struct Stack
 {
-  Node * _top;
+  void * _data; // pointer to anything
+  size_t _size;
+  size_t _capacity;
   size_t _elementSize;    // we need that for memcpy
 } Stack;
 
 /**
  * creates a new Stack object
  * @param elementSize : sizeof() the elements that this stack holds
- * @return : the stack
+ * @return : the stack, or NULL if the memory allocation failed.
  */
 Stack* stackAlloc(size_t elementSize);
 
@@ -40,7 +41,8 @@ Stack* stackAlloc(size_t elementSize);
 void freeStack(Stack** stack);
 
 /**
- * pushes the supplied data onto the given stack
+ * pushes the supplied data onto the given stack.
+ * if the buffer can't grow, prints an error and returns, the stack is not changed.
  * @param stack : a Stack object
  * @param data : address of a data var with type consistent in size to _elementSize
  */
@@ -56,15 +58,113 @@ void pop(Stack* stack, void *headData);
 
 /**
  * @param stack : stack object
- * @return 0 if the stack isn't empty, 0 otherwise.
+ * @return 1 if the stack is empty, 0 otherwise.
  */
 int isEmptyStack(Stack* stack);
 
 /**
  * @param stack a Stack object.
- * @return pointer containing the stack's top data.
- * notice! free this after calling.
+ * @return pointer to the stack's top data (inside the stack's buffer, so don't free it), or NULL
+ *         if the stack is empty. notice! it is valid until the next push or pop.
  */
 void* peek(Stack *stack);
 
+/**
+ * the num of elements that a typed stack holds in itself, before it allocates a buffer.
+ */
+#define TYPED_STACK_LOCAL_CAPACITY 64
+
+/**
+ * defines a stack of elements of type <TYPE>, named <NAME>, whose functions are prefixed by
+ * <PREFIX> (e.g. <PREFIX>Push). unlike Stack, the element size is known at compile time, so a
+ * push (pop) is a store (load) of an element plus a bounds check, and the functions are inline.
+ * the fields are:
+ * data: the elements (the top is the last of them), in <local> until there are more than
+ *       TYPED_STACK_LOCAL_CAPACITY of them, and in a malloc'd buffer that doubles after that.
+ *       (so a stack that is not copied, and stays small, never allocates memory).
+ * size: the num of elements.
+ * capacity: the num of elements that data has room for.
+ * local: the elements of a small stack.
+ * the functions are:
+ * <PREFIX>Init(stack): initializes an empty stack.
+ * <PREFIX>Push(stack, value): pushes value. returns 1 if succeed, 0 if the memory allocation
+ *                             failed (then the stack is not changed).
+ * <PREFIX>Pop(stack): pops the top element and returns it. notice! the stack must not be empty.
+ * <PREFIX>Top(stack): the address of the top element. notice! the stack must not be empty.
+ * <PREFIX>Size(stack): the num of elements.
+ * <PREFIX>Clear(stack): pops all the elements (the stack keeps its buffer).
+ * <PREFIX>Free(stack): frees the memory of the stack, and leaves it empty.
+ */
+#define DEFINE_TYPED_STACK(NAME, PREFIX, TYPE) \
+typedef struct NAME \
+{ \
+  TYPE * _data; \
+  size_t _size; \
+  size_t _capacity; \
+  TYPE _local[TYPED_STACK_LOCAL_CAPACITY]; \
+} NAME; \
+\
+static inline void PREFIX##Init(NAME* stack) \
+{ \
+    stack->_data = stack->_local; \
+    stack->_size = 0; \
+    stack->_capacity = TYPED_STACK_LOCAL_CAPACITY; \
+} \
+\
+static __attribute__((noinline, unused)) int PREFIX##Grow(NAME* stack) \
+{ \
+    TYPE* grown = (TYPE*)malloc(2 * stack->_capacity * sizeof(TYPE)); \
+    if (grown == NULL) \
+    { \
+        return 0; \
+    } \
+    memcpy(grown, stack->_data, stack->_size * sizeof(TYPE)); \
+    if (stack->_data != stack->_local) \
+    { \
+        free(stack->_data); \
+    } \
+    stack->_data = grown; \
+    stack->_capacity *= 2; \
+    return 1; \
+} \
+\
+static inline int PREFIX##Push(NAME* stack, const TYPE value) \
+{ \
+    if (__builtin_expect(stack->_size == stack->_capacity, 0) && !PREFIX##Grow(stack)) \
+    { \
+        return 0; \
+    } \
+    stack->_data[stack->_size++] = value; \
+    return 1; \
+} \
+\
+static inline TYPE PREFIX##Pop(NAME* stack) \
+{ \
+    return stack->_data[--stack->_size]; \
+} \
+\
+static inline TYPE* PREFIX##Top(NAME* stack) \
+{ \
+    return &stack->_data[stack->_size - 1]; \
+} \
+\
+static inline size_t PREFIX##Size(const NAME* stack) \
+{ \
+    return stack->_size; \
+} \
+\
+static inline void PREFIX##Clear(NAME* stack) \
+{ \
+    stack->_size = 0; \
+} \
+\
+static inline void PREFIX##Free(NAME* stack) \
+{ \
+    if (stack->_data != stack->_local) \
+    { \
+        free(stack->_data); \
+    } \
+    PREFIX##Init(stack); \
+}
+
 #endif
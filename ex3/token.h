@@ -1,68 +1,70 @@
-#ifndef TOKEN_H
-#define TOKEN_H
-#include <stddef.h>
-#define MEM_SEG_ERR "Error in memory allocation.\n"
-
-/**
- * holds the types of the arithmetical token.
- */
-typedef enum ArithmeticTokens
-{    Operand = 1,
-     Operator = 2,
-     Left_Parenthesis = 3,
-     Right_Parenthesis = 4
-}ArithmeticTokens;
-
-/**
- * a structure that represents an arithmetic token which has 2 fields:
- *    data: a string that holds the token's data.
- *    type: an Arithmetic Token the holds the token's type.
- */
-typedef struct token
-{
-    char *_data;
-    enum  ArithmeticTokens _type;
-}Token;
-
-/**
- * initializes a token, and returns it.
- * @param data : the data that the new token will hold.
- * @param size: number of chars to take from data.
- * @param type : the type that the new token will hold.
- * @return : the new initialized token.
- */
-Token *initializeToken(char *data, size_t size, enum ArithmeticTokens type);
-
-/**
- * creates a new Token object from another one (without changing the other's attributes).
- * @param other: Token object
- * @return : the new Token object whose fields are identical to <other>'s fields.
- */
- Token *const cloneToken(const Token* other);
-
-/**
- * deletes the supplied token.
- * notice: the class frees the token's data although it did not assigned memory to hold it.
- * @param token: the address of the Token object.
- */
-void freeToken(Token *token);
-
-/**
- * prints the token's data
- * @param token
- */
-void printData(const Token* token);
-
-/**
- * @param token : an address of a Token object.
- * @return: the given token's type.
- */
-const enum ArithmeticTokens getType(const Token* token);
-/**
- * @param token : an address of a Token object.
- * @return : the given token's data.
- */
-const char* getData(const Token* token);
-
-
-#endif //TOKEN_H
+#ifndef TOKEN_H
+#define TOKEN_H
+#include <stddef.h>
+#include <stdio.h>
+#include "arena.h"
+#define MEM_SEG_ERR "Error in memory allocation.\n"
+
+/**
+ * holds the types of the arithmetical token.
+ */
+typedef enum ArithmeticTokens
+{    Operand = 1,
+     Operator = 2,
+     Left_Parenthesis = 3,
+     Right_Parenthesis = 4,
+     Variable = 5
+}ArithmeticTokens;
+
+/**
+ * a structure that represents an arithmetic token which has 3 fields:
+ *    offset: the index in the expression's line of the token's first char.
+ *    length: the num of the token's chars.
+ *    type: an Arithmetic Token the holds the token's type.
+ * the token's data is a view into the line (it isn't copied), so it is only valid as long as the
+ * line is.
+ */
+typedef struct token
+{
+    size_t _offset;
+    size_t _length;
+    enum  ArithmeticTokens _type;
+}Token;
+
+/**
+ * initializes a token in the supplied arena, and returns it.
+ * @param arena : the arena that holds the token (see arena.h).
+ * @param offset : the index in the line of the token's first char.
+ * @param length : number of chars that the token takes from the line.
+ * @param type : the type that the new token will hold.
+ * @return : the new initialized token, or NULL if the memory allocation failed.
+ */
+Token *initializeToken(Arena *arena, size_t offset, size_t length, enum ArithmeticTokens type);
+
+/**
+ * prints the token's data
+ * @param stream: the stream to print to.
+ * @param line: the line that holds the token.
+ * @param token
+ */
+void printData(FILE *stream, const char *line, const Token* token);
+
+/**
+ * @param token : an address of a Token object.
+ * @return: the given token's type.
+ */
+const enum ArithmeticTokens getType(const Token* token);
+/**
+ * @param token : an address of a Token object.
+ * @param line: the line that holds the token.
+ * @return : the address of the given token's data (the num of its chars is getLength).
+ */
+const char* getData(const Token* token, const char *line);
+/**
+ * @param token : an address of a Token object.
+ * @return : the num of chars of the given token's data.
+ */
+size_t getLength(const Token* token);
+
+
+#endif //TOKEN_H